@@ -0,0 +1,144 @@
+#include "bench.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <malloc.h>
+
+using namespace std;
+
+
+//---------------------------------------------------
+// Heap accounting
+//---------------------------------------------------
+
+
+static atomic<size_t> heapInUse(0);
+static atomic<size_t> heapPeak(0);
+
+
+size_t heapBytesInUse() {
+	return heapInUse.load(memory_order_relaxed);
+}
+
+
+size_t heapPeakBytes() {
+	return heapPeak.load(memory_order_relaxed);
+}
+
+
+void resetHeapPeak() {
+	heapPeak.store(heapInUse.load(memory_order_relaxed), memory_order_relaxed);
+}
+
+
+void* operator new(size_t size) {
+	void* p = malloc(size != 0 ? size : 1);
+	if (p == nullptr)
+		throw bad_alloc();
+
+	const size_t usable = malloc_usable_size(p);
+	const size_t inUse = heapInUse.fetch_add(usable, memory_order_relaxed) + usable;
+
+	size_t peak = heapPeak.load(memory_order_relaxed);
+	while (inUse > peak && !heapPeak.compare_exchange_weak(peak, inUse, memory_order_relaxed)) {;}
+
+	return p;
+}
+
+
+void operator delete(void* p) noexcept {
+	if (p != nullptr) {
+		heapInUse.fetch_sub(malloc_usable_size(p), memory_order_relaxed);
+		free(p);
+	}
+}
+
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+
+//---------------------------------------------------
+// Resident memory
+//---------------------------------------------------
+
+
+size_t peakRssBytes() {
+	FILE* status = fopen("/proc/self/status", "r");
+	if (status == nullptr)
+		return 0;
+
+	char line[256];
+	size_t kib = 0;
+	while (fgets(line, sizeof(line), status) != nullptr) {
+		if (strncmp(line, "VmHWM:", 6) == 0) {
+			kib = strtoull(line + 6, nullptr, 10);
+			break;
+		}
+	}
+
+	fclose(status);
+	return kib * 1024;
+}
+
+
+bool resetPeakRss() {
+	// "5" resets the peak to the current resident size
+	FILE* refs = fopen("/proc/self/clear_refs", "w");
+	if (refs == nullptr)
+		return false;
+
+	const bool ok = fputs("5", refs) >= 0;
+	return fclose(refs) == 0 && ok;
+}
+
+
+
+//---------------------------------------------------
+// Main
+//---------------------------------------------------
+
+
+/* 64K, 32M, 1G, ... */
+static size_t parseSize(const char* str) {
+	char* suffix = nullptr;
+	size_t size = strtoull(str, &suffix, 10);
+
+	switch (*suffix) {
+	case 'k': case 'K': size <<= 10; break;
+	case 'm': case 'M': size <<= 20; break;
+	case 'g': case 'G': size <<= 30; break;
+	}
+
+	return size;
+}
+
+
+/*
+./lol_bench                  every benchmark, parsing up to 32 MiB
+./lol_bench parse [max size]  parsing only, up to max size (1G for the full range)
+./lol_bench table             lookups only
+*/
+int main(int argc, char** argv) {
+	const string which = argc > 1 ? argv[1] : "";
+	const size_t maxBytes = argc > 2 ? parseSize(argv[2]) : size_t(32) << 20;
+
+	if (which.empty() || which == "table") {
+		puts("------ TABLE <lookup & memory> ------");
+		benchTable();
+
+		puts("\n\n------ TABLE <batched lookups> ------");
+		benchBatch();
+	}
+
+	if (which.empty() || which == "parse") {
+		printf("%s------ PARSE <throughput, memory & lookups> ------\n", which.empty() ? "\n\n" : "");
+		benchParse(maxBytes);
+	}
+}
@@ -0,0 +1,46 @@
+#ifndef GG_CONFIG_BENCH_BENCH_HPP
+#define GG_CONFIG_BENCH_BENCH_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+/* Heap bytes currently allocated through operator new */
+size_t heapBytesInUse();
+
+/* Most heap bytes in use at once since the last reset */
+size_t heapPeakBytes();
+void resetHeapPeak();
+
+/* Peak resident set size of the process (VmHWM); resetting it needs Linux's clear_refs, 0 if it's not there */
+size_t peakRssBytes();
+bool resetPeakRss();
+
+
+/* Kinds of synthetic configs */
+enum class WORKLOAD {
+	SHORT_KEYS,     // key = value with short keys, every type
+	LONG_STRINGS,   // multi-line strings with escape sequences
+	NUMBERS,        // numbers in every notation, under dotted keys
+	COMMENTS,       // mostly comment lines
+	CHAINED         // assignment chains: a = b = c = value
+};
+
+const char* workloadName(WORKLOAD kind) noexcept;
+
+/* At least `bytes` of config text; up to maxSamples of its keys are picked uniformly into sampleKeys */
+std::string generateWorkload(WORKLOAD kind, size_t bytes, std::vector<std::string>& sampleKeys, size_t maxSamples, unsigned seed = 1);
+
+
+/* Lookup throughput and memory of ConfigStorage's table vs std::unordered_map */
+void benchTable();
+
+/* Bursts of lookups: one by one vs ConfigStorage::getMany() */
+void benchBatch();
+
+/* Parse throughput, peak memory and lookups for every workload, from 1 KiB up to maxBytes */
+void benchParse(size_t maxBytes);
+
+
+#endif // GG_CONFIG_BENCH_BENCH_HPP
@@ -0,0 +1,158 @@
+#include "bench.hpp"
+#include "../ggconfig.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace std;
+
+
+namespace {
+
+	const char* const benchPath = "/tmp/ggconfig_bench.ggconfig";
+
+	/* Runs repeat until there are at least MIN_RUNS of them and they took MIN_SECONDS, or MAX_RUNS is reached */
+	constexpr size_t MIN_RUNS = 3;
+	constexpr size_t MAX_RUNS = 1000;
+	constexpr double MIN_SECONDS = 0.5;
+
+	constexpr size_t SAMPLE_KEYS = 1 << 16;
+	constexpr size_t LOOKUPS_PER_RUN = 200000;
+	constexpr size_t LOOKUP_RUNS = 5;
+
+
+	/* Median and median absolute deviation of a set of runs; the deviation is relative to the median */
+	struct Stats {
+		double median;
+		double deviation;
+	};
+
+	Stats summarize(vector<double> samples) {
+		const auto median = [](vector<double>& v) {
+			nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+			return v[v.size() / 2];
+		};
+
+		Stats s;
+		s.median = median(samples);
+		for (double& x: samples)
+			x = fabs(x - s.median);
+		s.deviation = s.median != 0.0 ? median(samples) / s.median : 0.0;
+		return s;
+	}
+
+
+	double secondsSince(chrono::steady_clock::time_point begin) {
+		return chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	}
+
+
+	/* 1K, 32M, ... */
+	string formatSize(size_t bytes) {
+		const char* units = "BKMG";
+		while (bytes >= 1024 && bytes % 1024 == 0 && units[1] != '\0') {
+			bytes /= 1024;
+			++units;
+		}
+		return to_string(bytes) + (*units != 'B' ? string(1, *units) : "");
+	}
+
+
+	/* Nanoseconds per lookup, median of a few runs; sink keeps the lookups alive */
+	Stats timeLookups(const gg::ConfigStorage& cs, const vector<string>& probes, size_t& sink) {
+		vector<double> runs;
+
+		for (size_t r = 0; r < LOOKUP_RUNS; ++r) {
+			const auto begin = chrono::steady_clock::now();
+			for (size_t done = 0; done < LOOKUPS_PER_RUN; ) {
+				for (size_t i = 0; i < probes.size() && done < LOOKUPS_PER_RUN; ++i, ++done)
+					sink += cs.find(probes[i]) != nullptr;
+			}
+			runs.push_back(secondsSince(begin) * 1e9 / LOOKUPS_PER_RUN);
+		}
+
+		return summarize(runs);
+	}
+
+} // anon namespace
+
+
+void benchParse(size_t maxBytes) {
+	printf("%-12s | %5s | %-5s | %9s | %6s | %11s | %11s | %8s | %8s\n",
+	       "workload", "size", "mode", "MB/s", "+-", "heap peak", "RSS peak", "hit ns", "miss ns");
+
+	// without clear_refs the peak can't be reset, and the RSS column stays 0
+	const bool rssResets = resetPeakRss();
+	size_t sink = 0;
+
+	for (const WORKLOAD kind: {WORKLOAD::SHORT_KEYS, WORKLOAD::LONG_STRINGS, WORKLOAD::NUMBERS, WORKLOAD::COMMENTS, WORKLOAD::CHAINED}) {
+		for (size_t bytes = 1024; bytes <= maxBytes; bytes *= 32) {
+			vector<string> hits;
+			size_t fileSize;
+			{
+				const string text = generateWorkload(kind, bytes, hits, SAMPLE_KEYS);
+				fileSize = text.size();
+				if (!gg::writeFileAtomically(benchPath, text))
+					return;
+			}
+
+			// probes in random order, so lookups don't walk the table in insertion order
+			shuffle(hits.begin(), hits.end(), mt19937(1));
+			vector<string> misses(hits);
+			for (string& key: misses)
+				key += "_missing";
+
+			for (const bool lazy: {false, true}) {
+				gg::ParseOptions options;
+				options.lazy = lazy;
+
+				vector<double> runs;
+				size_t heapPeak = 0, rssPeak = 0;
+				Stats hit = Stats(), miss = Stats();
+
+				// the file is in the page cache: this is the parser's throughput, not the disk's
+				const auto started = chrono::steady_clock::now();
+				while (runs.size() < MAX_RUNS && (runs.size() < MIN_RUNS || secondsSince(started) < MIN_SECONDS)) {
+					// memory is measured on the first run, from where the peaks were reset to
+					const bool first = runs.empty();
+					if (first) {
+						resetHeapPeak();
+						resetPeakRss();
+					}
+					const size_t heapBefore = heapBytesInUse();
+					const size_t rssBefore = rssResets ? peakRssBytes() : 0;
+
+					gg::ConfigStorage cs;
+					const auto begin = chrono::steady_clock::now();
+					if (!cs.parseFile(benchPath, options))
+						return;
+					runs.push_back(static_cast<double>(fileSize) / 1e6 / secondsSince(begin));
+
+					if (first) {
+						heapPeak = heapPeakBytes() - heapBefore;
+						rssPeak = rssResets ? peakRssBytes() - rssBefore : 0;
+						hit = timeLookups(cs, hits, sink);
+						miss = timeLookups(cs, misses, sink);
+					}
+				}
+
+				const Stats mbps = summarize(runs);
+				printf("%-12s | %5s | %-5s | %9.1f | %5.1f%% | %10.1fM | %10.1fM | %8.1f | %8.1f\n",
+				       workloadName(kind), formatSize(bytes).c_str(), lazy ? "lazy" : "eager", mbps.median, mbps.deviation * 100,
+				       heapPeak / 1e6, rssPeak / 1e6, hit.median, miss.median);
+			}
+		}
+	}
+
+	unlink(benchPath);
+
+	if (sink == 1)
+		puts("");
+}
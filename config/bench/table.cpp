@@ -0,0 +1,178 @@
+#include "bench.hpp"
+#include "../ggconfig.hpp"
+#include "../ggconfig_key.hpp"
+#include "../ggconfig_table.hpp"
+#include "../ggconfig_value.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+	constexpr size_t LOOKUPS_PER_RUN = 4000000;
+
+	using value_t = gg::ConfigValue;
+
+	/* Nanoseconds per lookup; sink keeps the lookups alive */
+	template <typename Probe, typename Lookup>
+	double timeLookups(const vector<Probe>& probes, Lookup lookup, double& sink) {
+		const auto begin = chrono::steady_clock::now();
+
+		for (size_t done = 0; done < LOOKUPS_PER_RUN; ) {
+			for (size_t i = 0; i < probes.size() && done < LOOKUPS_PER_RUN; ++i, ++done)
+				sink += lookup(probes[i]);
+		}
+
+		const chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - begin;
+		return elapsed.count() / LOOKUPS_PER_RUN;
+	}
+
+} // anon namespace
+
+
+void benchTable() {
+	printf("%10s | %-13s | %12s | %12s | %12s\n", "keys", "container", "hit ns/op", "miss ns/op", "heap bytes");
+
+	for (size_t n: {1000ul, 100000ul, 1000000ul}) {
+		vector<string> keys, missing;
+		keys.reserve(n);
+		missing.reserve(n);
+		for (size_t i = 0; i < n; ++i) {
+			keys.push_back("service_db_pool_size_" + to_string(i));
+			missing.push_back("service_db_pool_size_x" + to_string(i));
+		}
+
+		// probes are copied in lookup order, so reading them is sequential and only the table misses the cache
+		vector<size_t> order(n);
+		for (size_t i = 0; i < n; ++i)
+			order[i] = i;
+		shuffle(order.begin(), order.end(), mt19937(1));
+
+		vector<string> hits, misses;
+		hits.reserve(n);
+		misses.reserve(n);
+		for (size_t i: order) {
+			hits.push_back(keys[i]);
+			misses.push_back(missing[i]);
+		}
+
+		double sink = 0.0;
+
+		{
+			const size_t heapBefore = heapBytesInUse();
+			unordered_map<string, value_t> map;
+			for (size_t i = 0; i < n; ++i)
+				map[keys[i]] = value_t(static_cast<double>(i));
+			const size_t heap = heapBytesInUse() - heapBefore;
+
+			const auto lookup = [&map](const string& key) {
+				const auto it = map.find(key);
+				return it != map.end() ? it->second.asNumber() : -1.0;
+			};
+
+			const double hit = timeLookups(hits, lookup, sink);
+			const double miss = timeLookups(misses, lookup, sink);
+			printf("%10zu | %-13s | %12.1f | %12.1f | %12zu\n", n, "unordered_map", hit, miss, heap);
+		}
+
+		{
+			const size_t heapBefore = heapBytesInUse();
+			gg::FlatTable<value_t> table;
+			for (size_t i = 0; i < n; ++i)
+				table[keys[i]] = value_t(static_cast<double>(i));
+			const size_t heap = heapBytesInUse() - heapBefore;
+
+			const auto lookup = [&table](const string& key) {
+				const value_t* v = table.find(key);
+				return v != nullptr ? v->asNumber() : -1.0;
+			};
+
+			const double hit = timeLookups(hits, lookup, sink);
+			const double miss = timeLookups(misses, lookup, sink);
+			printf("%10zu | %-13s | %12.1f | %12.1f | %12zu\n", n, "FlatTable", hit, miss, heap);
+
+			// same lookups with the hashes computed up front, like GG_KEY does at compile time
+			vector<gg::ConfigKey> hitKeys, missKeys;
+			for (size_t i = 0; i < n; ++i) {
+				hitKeys.emplace_back(hits[i]);
+				missKeys.emplace_back(misses[i]);
+			}
+
+			const auto lookupKey = [&table](const gg::ConfigKey& key) {
+				const value_t* v = table.find(key.name(), key.hash());
+				return v != nullptr ? v->asNumber() : -1.0;
+			};
+
+			const double keyHit = timeLookups(hitKeys, lookupKey, sink);
+			const double keyMiss = timeLookups(missKeys, lookupKey, sink);
+			printf("%10zu | %-13s | %12.1f | %12.1f | %12s\n", n, "+ ConfigKey", keyHit, keyMiss, "");
+		}
+
+		if (sink == 0.123)
+			puts("");
+	}
+}
+
+
+void benchBatch() {
+	constexpr size_t BURST = 32;
+	constexpr size_t BURSTS = 200000;
+
+	printf("%10s | %5s | %-22s | %10s\n", "keys", "burst", "lookup", "ns/key");
+
+	for (size_t n: {1000ul, 100000ul, 1000000ul}) {
+		gg::ConfigStorage cs;
+		for (size_t i = 0; i < n; ++i)
+			cs.set("service_db_pool_size_" + to_string(i), static_cast<double>(i));
+
+		// every burst asks for different keys, one in eight missing; enough of them that the big tables miss the cache
+		mt19937 rng(2);
+		vector<string> names(size_t(1) << 21);
+		for (size_t i = 0; i < names.size(); ++i)
+			names[i] = "service_db_pool_size_" + string(i % 8 == 7 ? "x" : "") + to_string(rng() % n);
+
+		vector<string_view> views(names.begin(), names.end());
+		vector<gg::ConfigKey> keys;
+		for (const string& name: names)
+			keys.emplace_back(name);
+
+		gg::ConfigStorage::value_t out[BURST];
+		double sink = 0.0;
+
+		const auto time = [&](const char* name, auto burst) {
+			const auto begin = chrono::steady_clock::now();
+			for (size_t b = 0; b < BURSTS; ++b) {
+				burst((b * BURST) % names.size());
+				sink += out[b % BURST].asNumber();
+			}
+			const chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - begin;
+			printf("%10zu | %5zu | %-22s | %10.1f\n", n, BURST, name, elapsed.count() / (BURSTS * BURST));
+		};
+
+		time("operator[] one by one", [&](size_t first) {
+			for (size_t i = 0; i < BURST; ++i)
+				out[i] = cs[views[first + i]];
+		});
+		time("getMany", [&](size_t first) {
+			cs.getMany(&views[first], BURST, out);
+		});
+		time("ConfigKey one by one", [&](size_t first) {
+			for (size_t i = 0; i < BURST; ++i)
+				out[i] = cs[keys[first + i]];
+		});
+		time("getMany, ConfigKey", [&](size_t first) {
+			cs.getMany(&keys[first], BURST, out);
+		});
+
+		if (sink == 0.123)
+			puts("");
+	}
+}
@@ -0,0 +1,174 @@
+#include "bench.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+	/* Appends statements of one kind until the text is big enough; keys are sampled uniformly on the way */
+	class Generator {
+	public:
+		Generator(size_t bytes, vector<string>& sampleKeys, size_t maxSamples, unsigned seed)
+			: bytes(bytes)
+			, sampleKeys(sampleKeys)
+			, maxSamples(maxSamples)
+			, keysSeen(0)
+			, rng(seed)
+		{
+			sampleKeys.clear();
+			text.reserve(bytes + 4096);
+		}
+
+		bool full() const noexcept { return text.size() >= bytes; }
+		string&& result() noexcept { return std::move(text); }
+
+		size_t pick(size_t n) { return uniform_int_distribution<size_t>(0, n - 1)(rng); }
+
+		/* Appends a key and remembers it with reservoir sampling */
+		void key(const string& name) {
+			text += name;
+
+			++keysSeen;
+			if (sampleKeys.size() < maxSamples)
+				sampleKeys.push_back(name);
+			else if (size_t slot = pick(keysSeen); slot < maxSamples)
+				sampleKeys[slot] = name;
+		}
+
+		void append(const string& str) { text += str; }
+		void append(char c) { text += c; }
+
+		/* Some letters and digits */
+		void word(size_t length) {
+			static const char chars[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+			for (size_t i = 0; i < length; ++i)
+				text += chars[pick(sizeof(chars) - 1)];
+		}
+
+		void number() {
+			switch (pick(4)) {
+			case 0:  text += to_string(pick(100000)); break;
+			case 1:  text += to_string(uniform_real_distribution<double>(-1e3, 1e3)(rng)); break;
+			case 2:  text += to_string(pick(10)) + "." + to_string(pick(1000)) + "e" + (pick(2) ? "-" : "") + to_string(pick(300)); break;
+			default: text += "-0." + to_string(pick(1000000)); break;
+			}
+		}
+
+	private:
+		const size_t bytes;
+		vector<string>& sampleKeys;
+		const size_t maxSamples;
+		size_t keysSeen;
+		mt19937_64 rng;
+		string text;
+	};
+
+
+	/* key = value, keys of a few chars, all types */
+	void shortKeys(Generator& g, size_t i) {
+		g.key("k" + to_string(i));
+		g.append(" = ");
+		switch (i % 3) {
+		case 0:  g.number(); break;
+		case 1:  g.append('"'); g.word(4 + g.pick(8)); g.append('"'); break;
+		default: g.append(g.pick(2) ? "true" : "false"); break;
+		}
+		g.append('\n');
+	}
+
+
+	/* Long strings over several lines, with escape sequences here and there */
+	void longStrings(Generator& g, size_t i) {
+		g.key("text_" + to_string(i));
+		g.append(" = \"");
+		const size_t lines = 1 + g.pick(16);
+		for (size_t l = 0; l < lines; ++l) {
+			for (size_t w = 8 + g.pick(8); w != 0; --w) {
+				g.word(2 + g.pick(8));
+				g.append(g.pick(20) == 0 ? "\\\" " : " ");
+			}
+			g.append(g.pick(4) == 0 ? "\\n" : "\n");
+		}
+		g.append("\"\n");
+	}
+
+
+	/* Every value a number, in every notation */
+	void numbers(Generator& g, size_t i) {
+		g.key("metrics.sensor_" + to_string(i % 1000) + ".sample_" + to_string(i / 1000));
+		g.append(" = ");
+		g.number();
+		g.append('\n');
+	}
+
+
+	/* Mostly comments: whole line ones and trailing ones */
+	void comments(Generator& g, size_t i) {
+		for (size_t c = 1 + g.pick(4); c != 0; --c) {
+			g.append("# ");
+			for (size_t w = 4 + g.pick(10); w != 0; --w) {
+				g.word(2 + g.pick(8));
+				g.append(g.pick(10) == 0 ? " \"quoted\" = " : " ");
+			}
+			g.append('\n');
+		}
+		g.key("commented_" + to_string(i));
+		g.append(" = ");
+		g.number();
+		g.append("   # trailing comment\n");
+	}
+
+
+	/* Assignment chains of 2-8 keys */
+	void chained(Generator& g, size_t i) {
+		for (size_t k = 2 + g.pick(7); k != 0; --k) {
+			g.key("chain_" + to_string(i) + "_" + to_string(k));
+			g.append(" = ");
+		}
+		if (g.pick(2)) {
+			g.append('"');
+			g.word(16 + g.pick(48));
+			g.append('"');
+		} else {
+			g.number();
+		}
+		g.append('\n');
+	}
+
+} // anon namespace
+
+
+const char* workloadName(WORKLOAD kind) noexcept {
+	switch (kind) {
+	case WORKLOAD::SHORT_KEYS:   return "short keys";
+	case WORKLOAD::LONG_STRINGS: return "long strings";
+	case WORKLOAD::NUMBERS:      return "numbers";
+	case WORKLOAD::COMMENTS:     return "comments";
+	case WORKLOAD::CHAINED:      return "chained";
+	}
+
+	return "";
+}
+
+
+string generateWorkload(WORKLOAD kind, size_t bytes, vector<string>& sampleKeys, size_t maxSamples, unsigned seed) {
+	Generator g(bytes, sampleKeys, maxSamples, seed);
+
+	void (*statement)(Generator&, size_t) = nullptr;
+	switch (kind) {
+	case WORKLOAD::SHORT_KEYS:   statement = shortKeys; break;
+	case WORKLOAD::LONG_STRINGS: statement = longStrings; break;
+	case WORKLOAD::NUMBERS:      statement = numbers; break;
+	case WORKLOAD::COMMENTS:     statement = comments; break;
+	case WORKLOAD::CHAINED:      statement = chained; break;
+	}
+
+	for (size_t i = 0; !g.full(); ++i)
+		statement(g, i);
+
+	return g.result();
+}
@@ -1,102 +1,150 @@
 #include "ggconfig.hpp"
+#include "ggconfig_scan.hpp"
 
-#include <vector>
-#include <fstream>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
 
 using namespace std;
 
 
 namespace {
 
-	/* Parses a file, without any thread-safety mechanics */
-	class FileParser {
-	public:
-		/*
-		Throws invalid_argument if the file could not be opened.
-		what() will return the requested file path.
-		*/
-		FileParser(gg::ConfigStorage& cs, const char* path);
+	/* The first 8 bytes of a key as a big endian number: compares like the key, as far as it goes */
+	uint64_t sortPrefix(string_view key) noexcept {
+		uint64_t prefix = 0;
+		for (size_t i = 0; i < 8; ++i)
+			prefix = (prefix << 8) | (i < key.size() ? static_cast<unsigned char>(key[i]) : 0);
+		return prefix;
+	}
 
-		/* Parse the opened file */
-		bool parseFile();
 
-		/* Get the current state of the parser as a string */
-		const char* getState() const noexcept;
+	uint64_t nanosecondsSince(chrono::steady_clock::time_point start) noexcept {
+		return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+	}
 
-		/* Print error to console */
-		void printError(const char* msg = "OK");
 
-	private:
-		/* Linked storage */
-		gg::ConfigStorage::storage_t& storage;
+	/* Drops every value; for parsing something again only to print its error */
+	class IgnoreValues: public gg::ConfigHandler {
+	public:
+		bool onValue(const vector<string_view>&, const gg::RawValue&) override { return true; }
+	};
 
-		/* File */
-		ifstream file;
+} // anon namespace
 
-		/* State vars */
-		gg::ConfigStorage::STATE state, nextState;
-		/* Current char */
-		char currentChar;
-		/* Key/value that is being parsed */
-		string currentToken;
 
-		/* The keys that are currently being declared */
-		vector<string> pendingKeys;
+namespace gg {
 
-		/* Position info */
-		size_t lineCount, linePosCount;
+	/* Copies every assignment into the storage, or, when parsing lazily, points at it */
+	class ConfigStorage::Loader: public ConfigHandler {
+	public:
+		/* Where the last value ended in the input: the end of its last statement */
+		const char* lastValueEnd;
 
-		/* Get the next char from the file */
-		bool fetchChar();
+		Loader(ConfigStorage& cs, bool lazy)
+			: lastValueEnd(nullptr)
+			, cs(cs)
+			, lazy(lazy)
+			, unescaped()
+		{;}
 
-		unsigned char getCurrentUchar() {
-			return static_cast<unsigned char>(currentChar);
-		}
+		bool onValue(const vector<string_view>& keys, const RawValue& value) override {
+			// strings end with the closing quote, after the text
+			lastValueEnd = value.text.data() + value.text.size() + (value.type == value_t::TYPE::STRING);
 
-		/* Insert current keys into the table */
-		void insertPendingKeys();
-		void insertPendingKeys(bool value);
-		void insertPendingKeys(double value); 
+			value_t v;
+
+			switch (value.type) {
+			case value_t::TYPE::STRING:
+				v = lazy ? makeLazy(value) : makeString(value);
+				break;
+			case value_t::TYPE::NUMBER:
+				v = value_t(value.number);
+				break;
+			case value_t::TYPE::BOOL:
+				v = value_t(value.boolean);
+				break;
+			case value_t::TYPE::NONE:
+				return true;
+			}
+
+			// chained keys share the value: its bytes are stored once, every key gets the same 16 bytes
+			for (const auto& k: keys)
+				cs.storage[k] = v;
 
-		bool handleEndOfBoolLiteralCandidate(bool value);		
-		bool handleIsNotBoolLiteral() {
-			state = gg::ConfigStorage::STATE::LVAL;
-			currentToken.append(1, currentChar);
 			return true;
 		}
 
-		/* Parsing for the different states */
-		bool handleInitState();
-		bool handleLvalState();
-		bool handleRvalState();
-		bool handleStrState();
-		bool handleNumState();
-		bool handleTrueState();
-		bool handleFalseState();
-		bool handleAsgnState();
-	};
+	private:
+		ConfigStorage& cs;
+		const bool lazy;
 
-} // anon namespace
+		/* Reused for strings with escape sequences */
+		string unescaped;
 
+		/* Copied into the arena */
+		value_t makeString(const RawValue& value) {
+			if (!value.escaped)
+				return value_t::makeString(value.text, cs.strings);
 
-namespace gg {
+			unescaped.clear();
+			unescape(value.text, unescaped);
+			return value_t::makeString(unescaped, cs.strings);
+		}
+
+		/* The text stays in the mapped file */
+		value_t makeLazy(const RawValue& value) {
+			if (!value.escaped)
+				return value_t::makeStringView(value.text);
 
-	ConfigStorage::value_t ConfigStorage::null = ConfigStorage::value_t(string("null"));
+			cs.lazyStrings.emplace_back(value.text);
+			return value_t::makeLazyString(cs.lazyStrings.back());
+		}
+	};
+
+
+	const ConfigStorage::value_t ConfigStorage::null = ConfigStorage::value_t();
 
 	ConfigStorage::ConfigStorage()
 		: storage()
+		, strings()
+		, sources()
+		, lazyStrings()
+		, index(new PrefixIndex())
+		, stats(nullptr)
+		, absorbed()
 	{;}
 
 
 	ConfigStorage::~ConfigStorage() {;}
 
 
-	bool ConfigStorage::parseFile(const char* path) {
+	bool ConfigStorage::parseFile(const char* path, const ParseOptions& options) {
 		try {
-			::FileParser p(*this, path);
-			return p.parseFile();
+			invalidateIndex();
+
+			const auto start = chrono::steady_clock::now();
+			unique_ptr<MappedFile> file(new MappedFile(path));
+			const char* begin = file->begin();
+			const char* end = file->end();
+
+			if (stats != nullptr)
+				stats->recordPhase(ConfigStats::PHASE::READ, nanosecondsSince(start));
+
+			// kept even if parsing fails: the values parsed until then point into it
+			if (options.lazy)
+				sources.push_back(std::move(file));
+
+			return parse(begin, end, options);
 		} catch (const invalid_argument& e) {
 			fprintf(stderr, "%s\n", e.what());
 			return false;
@@ -107,388 +155,316 @@ namespace gg {
 	}
 
 
-	ConfigStorage::value_t& ConfigStorage::operator[](const string& key) {
-		auto elem = storage.find(key);
-
-		if (elem != storage.end())
-			return elem->second;
-
-		return null;
-	}
-
-
-	const ConfigStorage::value_t& ConfigStorage::operator[](const string& key) const {
-		const auto elem = storage.find(key);
-
-		if (elem != storage.cend())
-			return elem->second;
-
-		return null;
-	}
-
-} // namespace gg
-
-
-namespace {
-
-	FileParser::FileParser(gg::ConfigStorage& cs, const char* path)
-		: storage(cs.storage)
-		, file(path)
-		, state()
-		, nextState()
-		, currentChar()
-		, currentToken()
-		, pendingKeys()
-		, lineCount()
-		, linePosCount()
-	{
-		if (!file.is_open()) 
-			throw invalid_argument(string(path) + " could not be opened");
-	}
-
-
-	bool FileParser::fetchChar() {
-		if (!file.good() || (currentChar = file.get()) == EOF)
+	bool ConfigStorage::parseBuffer(const char* data, size_t size, const ParseOptions& options) {
+		try {
+			invalidateIndex();
+			return parse(data, data + size, options);
+		} catch(const exception& e) {
+			fprintf(stderr, "Unexpected ERROR: %s\n", e.what());
 			return false;
-
-		if (currentChar == '\n') {
-			lineCount++;
-			linePosCount = 0;
-		} else {
-			linePosCount++;
 		}
-
-		return true;
 	}
 
 
-	bool FileParser::parseFile() {
-		state = gg::ConfigStorage::STATE::INIT;
-		nextState = gg::ConfigStorage::STATE::INIT;
-
-		lineCount = 1;
-		linePosCount = 0;
-		currentChar = '?';
-
-		while (fetchChar()) {
-			switch (state) {
-			case gg::ConfigStorage::STATE::INIT:
-				if (!handleInitState()) {
-					printError("Unexpected character encountered.");
-					return false;
-				}
-				break;
-			case gg::ConfigStorage::STATE::LVAL:
-				if (!handleLvalState()) {
-					printError("Identifier expected.");
-					return false;
-				}
-				break;
-			case gg::ConfigStorage::STATE::RVAL:
-				if (!handleRvalState()) {
-					printError("Value expected.");
-					return false;
-				}
-				break;
-			case gg::ConfigStorage::STATE::STR:
-				if (!handleStrState()) {
-					printError("String expected.");
-					return false;
-				}
-				break;
-			case gg::ConfigStorage::STATE::NUM:
-				if (!handleNumState()) {
-					printError("Number expected.");
-					return false;
-				}
-				break;
-			case gg::ConfigStorage::STATE::TRUE:
-				if (!handleTrueState()) {
-					printError("\"true\" expected.");
-					return false;
+	bool ConfigStorage::parseStream(const ReadFn& read, size_t blockSize) {
+		try {
+			invalidateIndex();
+
+			Loader loader(*this, false);
+			vector<char> block(max<size_t>(blockSize, 1));
+			size_t filled = 0;
+			size_t firstLine = 1;
+
+			// what's carried over to the next block is profiled twice, it's a statement per block at most
+			ParseProfile profile;
+			ParseProfile* const profiling = stats != nullptr ? &profile : nullptr;
+			uint64_t total = 0, readTime = 0;
+			const auto start = chrono::steady_clock::now();
+
+			for (;;) {
+				// fill the whole block: pipes hand over a little at a time
+				const auto readStart = chrono::steady_clock::now();
+				bool finished = false;
+				while (filled < block.size() && !finished) {
+					const ptrdiff_t n = read(block.data() + filled, block.size() - filled);
+					if (n < 0) {
+						fprintf(stderr, "Reading the config failed\n");
+						return false;
+					}
+
+					filled += static_cast<size_t>(n);
+					total += static_cast<size_t>(n);
+					finished = n == 0;
 				}
-				break;
-			case gg::ConfigStorage::STATE::FALSE:
-				if (!handleFalseState()) {
-					printError("\"false\" expected.");
-					return false;
+				readTime += nanosecondsSince(readStart);
+
+				const char* begin = block.data();
+				if (finished) {
+					const bool ok = parseConfig(begin, begin + filled, loader, firstLine, profiling);
+					if (stats != nullptr) {
+						stats->recordPhase(ConfigStats::PHASE::READ, readTime);
+						stats->recordPhase(ConfigStats::PHASE::PARSE, nanosecondsSince(start) - readTime);
+						stats->recordParse(total, profile);
+					}
+					return ok;
 				}
-				break;
-			case gg::ConfigStorage::STATE::ASGN:
-				if (!handleAsgnState()) {
-					printError("Assignment operator (\"=\") expected.");
-					return false;
+
+				// up to the last whitespace no token is cut in half, only strings and comments can go on
+				const char* cut = begin + filled;
+				while (cut != begin && !scan::isSpace(cut[-1]))
+					--cut;
+
+				const char* resume = begin;
+				if (cut != begin) {
+					loader.lastValueEnd = nullptr;
+					const ParseResult result = parseConfigPart(begin, cut, loader, profiling);
+
+					if (!result.ok) {
+						// the error is a real one, parse again to print it with its line number
+						IgnoreValues ignore;
+						parseConfig(begin, cut, ignore, firstLine);
+						return false;
+					}
+
+					// between two statements the whole part is done, otherwise what's after the last value is parsed again
+					if (result.state == STATE::INIT)
+						resume = cut;
+					else if (loader.lastValueEnd != nullptr)
+						resume = loader.lastValueEnd;
 				}
-				break;
-			case gg::ConfigStorage::STATE::CMNT:
-				if (currentChar == '\n') {
-					state = nextState;
-					nextState = gg::ConfigStorage::STATE::INIT;
+
+				if (resume == begin) {
+					// a single statement fills the block: make room for more of it
+					block.resize(block.size() * 2);
+					continue;
 				}
-				break;
-			}
-		}
 
-		if (state == gg::ConfigStorage::STATE::INIT) {
-			return true;
-		} else {
-			printError("Parsing finished in an unexpected state");
+				firstLine += scan::countNewlines(begin, resume);
+				filled -= resume - begin;
+				memmove(block.data(), resume, filled);
+			}
+		} catch(const exception& e) {
+			fprintf(stderr, "Unexpected ERROR: %s\n", e.what());
 			return false;
 		}
 	}
 
 
-	void FileParser::insertPendingKeys() {
-		for (const auto& k: pendingKeys)
-			storage[k] = currentToken;
-		pendingKeys.clear();
+	bool ConfigStorage::parseStream(int fd) {
+		return parseStream([fd](char* buffer, size_t capacity) -> ptrdiff_t {
+			for (;;) {
+				const ssize_t n = ::read(fd, buffer, capacity);
+				if (n >= 0 || errno != EINTR)
+					return n;
+			}
+		});
 	}
 
 
-	void FileParser::insertPendingKeys(bool value) {
-		for (const auto& k: pendingKeys)
-			storage[k] = value;
-		pendingKeys.clear();
-	}
-
+	bool ConfigStorage::parse(const char* begin, const char* end, const ParseOptions& options) {
+		const size_t threads = options.threads != 0 ? options.threads : max(thread::hardware_concurrency(), 1u);
+		const size_t numOfChunks = min(threads, static_cast<size_t>(end - begin) / MIN_CHUNK_SIZE);
 
-	void FileParser::insertPendingKeys(double value) {
-		for (const auto& k: pendingKeys)
-			storage[k] = value;
-		pendingKeys.clear();
-	}
+		ParseProfile profile;
+		ParseProfile* const profiling = stats != nullptr ? &profile : nullptr;
+		bool ok;
 
+		if (numOfChunks > 1) {
+			ok = parseParallel(begin, end, options, numOfChunks, profiling);
+		} else {
+			const auto start = chrono::steady_clock::now();
+			Loader loader(*this, options.lazy);
+			ok = parseConfig(begin, end, loader, 1, profiling);
 
-	bool FileParser::handleInitState() {
-		if (!isspace(getCurrentUchar())) {
-			if (isdigit(getCurrentUchar()) || currentChar == '-' || currentChar == '+' || currentChar == '.') {
-				return handleNumState();
-			} else if (isalpha(getCurrentUchar()) || currentChar == '_') {
-				switch (currentChar) {
-				case 't':
-					return handleTrueState();
-				case 'f':
-					return handleFalseState();
-				default:
-					currentToken.clear();
-					currentToken.append(1, currentChar);
-					state = gg::ConfigStorage::STATE::LVAL;
-					break;
-				}
-			} else if (currentChar == '#') {
-				state = gg::ConfigStorage::STATE::CMNT;
-				nextState = gg::ConfigStorage::STATE::INIT;
-			} else {
-				return false;
-			}
+			if (stats != nullptr)
+				stats->recordPhase(ConfigStats::PHASE::PARSE, nanosecondsSince(start));
 		}
 
-		return true;
+		if (stats != nullptr)
+			stats->recordParse(end - begin, profile);
+		return ok;
 	}
 
 
-	bool FileParser::handleLvalState() {
-		if (isalnum(getCurrentUchar()) || currentChar == '_') {
-			currentToken.append(1, currentChar);
-		} else if (isspace(getCurrentUchar())) {
-			pendingKeys.push_back(currentToken);
-			state = gg::ConfigStorage::STATE::ASGN;
-		} else if (currentChar == '=') {
-			pendingKeys.push_back(currentToken);
-			state = gg::ConfigStorage::STATE::RVAL;
-		} else if (currentChar == '#') {
-			pendingKeys.push_back(currentToken);
-			state = gg::ConfigStorage::STATE::CMNT;
-			nextState = gg::ConfigStorage::STATE::ASGN;
-		} else {
-			return false;
+	bool ConfigStorage::parseParallel(const char* begin, const char* end, const ParseOptions& options, size_t numOfChunks, ParseProfile* profile) {
+		const auto start = chrono::steady_clock::now();
+
+		// cut right after a line end: no token can span the cut, but a string or a comment still can
+		vector<const char*> cuts(1, begin);
+		for (size_t i = 1; i < numOfChunks; ++i) {
+			const char* cut = scan::findNewline(begin + (end - begin) * i / numOfChunks, end);
+			if (cut != end && cut + 1 > cuts.back())
+				cuts.push_back(cut + 1);
+		}
+		cuts.push_back(end);
+
+		const size_t n = cuts.size() - 1;
+		vector<ConfigStorage> parts(n);
+		vector<ParseResult> results(n);
+		vector<ParseProfile> profiles(profile != nullptr ? n : 0);
+
+		const auto parseChunk = [&](size_t i) {
+			try {
+				Loader loader(parts[i], options.lazy);
+				results[i] = parseConfigPart(cuts[i], cuts[i + 1], loader, profile != nullptr ? &profiles[i] : nullptr);
+			} catch (const exception&) {
+				results[i].ok = false;
+			}
+		};
+
+		vector<thread> workers;
+		for (size_t i = 1; i < n; ++i)
+			workers.emplace_back(parseChunk, i);
+		parseChunk(0);
+		for (auto& w: workers)
+			w.join();
+
+		if (stats != nullptr)
+			stats->recordPhase(ConfigStats::PHASE::PARSE, nanosecondsSince(start));
+		const auto mergeStart = chrono::steady_clock::now();
+
+		size_t total = storage.size();
+		for (const auto& part: parts)
+			total += part.storage.size();
+		storage.reserve(total);
+
+		// a chunk that ends between two statements was parsed exactly like a sequential parse would have,
+		// and so the next chunk really starts at a statement
+		size_t merged = 0;
+		while (merged < n && results[merged].ok && results[merged].state == STATE::INIT) {
+			absorb(std::move(parts[merged]));
+			if (profile != nullptr)
+				*profile += profiles[merged];
+			++merged;
 		}
 
-		return true;
-	}
+		if (stats != nullptr)
+			stats->recordPhase(ConfigStats::PHASE::MERGE, nanosecondsSince(mergeStart));
 
+		if (merged == n)
+			return true;
 
-	bool FileParser::handleRvalState() {
-		if (handleInitState()) {
-			if (state == gg::ConfigStorage::STATE::CMNT)
-				nextState = gg::ConfigStorage::STATE::RVAL;
-		} else if (currentChar == '"') {
-			state = gg::ConfigStorage::STATE::STR;
-			currentToken.clear();
-		} else {
-			return false;
-		}
+		// the rest is parsed the normal way, errors included
+		const auto restStart = chrono::steady_clock::now();
+		Loader loader(*this, options.lazy);
+		const bool ok = parseConfig(cuts[merged], end, loader, 1 + scan::countNewlines(begin, cuts[merged]), profile);
 
-		return true;
+		if (stats != nullptr)
+			stats->recordPhase(ConfigStats::PHASE::PARSE, nanosecondsSince(restStart));
+		return ok;
 	}
 
 
-	bool FileParser::handleStrState() {
-		if (currentChar == '\\') {
-			if (!fetchChar())
-				return false;
+	void ConfigStorage::absorb(ConfigStorage&& part) {
+		// the stored hash is the low half of the full hash, that's all insert() looks at
+		for (const auto& e: part.storage)
+			storage.insert(e.key(), e.hash).first = e.value;
 
-			switch (currentChar) {
-			case '\\':
-			case '"':
-				currentToken.append(1, currentChar);
-				break;
+		// the values stay where they are: keep what they point to, drop the rest
+		part.storage = storage_t();
+		absorbed.push_back(std::move(part));
+	}
 
-			case 'n':
-				currentToken.append(1, '\n');
-				break;
 
-			case 't':
-				currentToken.append(1, '\t');
-				break;
+	void ConfigStorage::getMany(const string_view* keys, size_t n, value_t* out) const noexcept {
+		uint64_t hashes[LOOKUP_BATCH];
+
+		for (size_t first = 0; first < n; first += LOOKUP_BATCH) {
+			const size_t count = min(LOOKUP_BATCH, n - first);
 
-			default: {
-					const char str[] = {'\\', currentChar, '\0'};
-					currentToken.append(str);
-				} break;
+			for (size_t i = 0; i < count; ++i) {
+				hashes[i] = hashKey(keys[first + i]);
+				storage.prefetch(hashes[i]);
 			}
-		} else if (currentChar == '"') {
-			insertPendingKeys();
-			state = gg::ConfigStorage::STATE::INIT;
-		} else {
-			currentToken.append(1, currentChar);
-		}
 
-		return true;
+			for (size_t i = 0; i < count; ++i)
+				out[first + i] = orNull(stats == nullptr ? storage.find(keys[first + i], hashes[i]) : findCounted(keys[first + i], hashes[i]));
+		}
 	}
 
 
-	bool FileParser::handleNumState() {
-		state = gg::ConfigStorage::STATE::NUM;
-		currentToken.clear();
-
-		do {
-			currentToken.append(1, currentChar);
-		} while (fetchChar() && (!isspace(getCurrentUchar()) && currentChar != '#'));
+	void ConfigStorage::getMany(const ConfigKey* keys, size_t n, value_t* out) const noexcept {
+		for (size_t first = 0; first < n; first += LOOKUP_BATCH) {
+			const size_t count = min(LOOKUP_BATCH, n - first);
 
-		size_t pos;
-		double val;
+			for (size_t i = 0; i < count; ++i)
+				storage.prefetch(keys[first + i].hash());
 
-		try {
-			val = stod(currentToken, &pos);
-		} catch (const invalid_argument& e) {
-			return false;
-		} catch (const out_of_range& e) {
-			return false;
+			for (size_t i = 0; i < count; ++i)
+				out[first + i] = orNull(find(keys[first + i]));
 		}
+	}
 
-		if (pos != currentToken.size()) {
-			return false;
-		}
 
-		insertPendingKeys(val);
-		state = gg::ConfigStorage::STATE::INIT;
-		return true;
+	void ConfigStorage::set(string_view key, string_view value) {
+		invalidateIndex();
+		storage[key] = value_t::makeString(value, strings);
 	}
 
 
-	// candidate
-	bool FileParser::handleEndOfBoolLiteralCandidate(bool value) {
-		if (file.good()) {
-			char ch = file.peek();
-
-			if (!isspace(static_cast<unsigned char>(ch))) {
-				if (ch != '=') {
-					state = gg::ConfigStorage::STATE::LVAL;
-					return true;
-				}
+	void ConfigStorage::set(string_view key, double value) {
+		invalidateIndex();
+		storage[key] = value_t(value);
+	}
 
-				fetchChar();
-				return false;
-			}
-		}
 
-		state = gg::ConfigStorage::STATE::INIT;
-		insertPendingKeys(value);
-		return true;
+	void ConfigStorage::set(string_view key, bool value) {
+		invalidateIndex();
+		storage[key] = value_t(value);
 	}
 
 
-	bool FileParser::handleTrueState() {
-		state = gg::ConfigStorage::STATE::TRUE;
+	bool ConfigStorage::erase(string_view key) {
+		invalidateIndex();
+		return storage.erase(key);
+	}
 
-		currentToken = "t";
-		if (!fetchChar() || currentChar != 'r') return handleIsNotBoolLiteral();
-		currentToken.append(1, currentChar);
-		if (!fetchChar() || currentChar != 'u') return handleIsNotBoolLiteral();
-		currentToken.append(1, currentChar);
-		if (!fetchChar() || currentChar != 'e') return handleIsNotBoolLiteral();
-		currentToken.append(1, currentChar);
 
-		return handleEndOfBoolLiteralCandidate(true);
-	}
+	ConfigView ConfigStorage::view() const {
+		// a moved-from storage has no index, and no keys either
+		if (index == nullptr)
+			return ConfigView();
 
+		if (!index->built.load(memory_order_acquire)) {
+			lock_guard<mutex> lock(index->lock);
 
-	bool FileParser::handleFalseState() {
-		state = gg::ConfigStorage::STATE::FALSE;
+			if (!index->built.load(memory_order_relaxed)) {
+				const auto start = chrono::steady_clock::now();
 
-		currentToken = "f";
-		if (!fetchChar() || currentChar != 'a') return handleIsNotBoolLiteral();
-		currentToken.append(1, currentChar);
-		if (!fetchChar() || currentChar != 'l') return handleIsNotBoolLiteral();
-		currentToken.append(1, currentChar);
-		if (!fetchChar() || currentChar != 's') return handleIsNotBoolLiteral();
-		currentToken.append(1, currentChar);
-		if (!fetchChar() || currentChar != 'e') return handleIsNotBoolLiteral();
-		currentToken.append(1, currentChar);
+				// sorted by the first 8 bytes first: most comparisons don't have to follow the key pointers
+				vector<pair<uint64_t, IndexedEntry>> sorted;
+				sorted.reserve(storage.size());
+				for (const auto& e: storage)
+					sorted.emplace_back(sortPrefix(e.key()), IndexedEntry{e.key(), &e.value});
 
-		return handleEndOfBoolLiteralCandidate(false);
-	}
+				sort(sorted.begin(), sorted.end(), [](const pair<uint64_t, IndexedEntry>& a, const pair<uint64_t, IndexedEntry>& b) {
+					return a.first != b.first ? a.first < b.first : a.second.key < b.second.key;
+				});
+
+				index->entries.clear();
+				index->entries.reserve(sorted.size());
+				for (const auto& e: sorted)
+					index->entries.push_back(e.second);
 
+				index->built.store(true, memory_order_release);
 
-	bool FileParser::handleAsgnState() {
-		if (!isspace(getCurrentUchar())) {
-			if (currentChar == '=') {
-				state = gg::ConfigStorage::STATE::RVAL;
-			} else if (currentChar == '#') {
-				state = gg::ConfigStorage::STATE::CMNT;
-				nextState = gg::ConfigStorage::STATE::ASGN;
-			} else {
-				return false;
+				if (stats != nullptr)
+					stats->recordPhase(ConfigStats::PHASE::INDEX, nanosecondsSince(start));
 			}
 		}
 
-		return true;
+		const IndexedEntry* first = index->entries.data();
+		return ConfigView(first, first + index->entries.size(), 0);
 	}
 
 
-	const char* FileParser::getState() const noexcept {
-		switch (state) {
-		case gg::ConfigStorage::STATE::INIT:
-			return "INIT";
-		case gg::ConfigStorage::STATE::LVAL:
-			return "IDENTIFIER";
-		case gg::ConfigStorage::STATE::RVAL:
-			return "VALUE";
-		case gg::ConfigStorage::STATE::STR:
-			return "STRING";
-		case gg::ConfigStorage::STATE::TRUE:
-			return "TRUE";
-		case gg::ConfigStorage::STATE::FALSE:
-			return "FALSE";
-		case gg::ConfigStorage::STATE::NUM:
-			return "NUMBER";
-		case gg::ConfigStorage::STATE::ASGN:
-			return "ASSIGN";
-		case gg::ConfigStorage::STATE::CMNT:
-			return "COMMENT";
-		}
-	}
-
+	void ConfigStorage::invalidateIndex() {
+		// a moved-from storage that's filled again gets a new one
+		if (index == nullptr)
+			index.reset(new PrefixIndex());
 
-	void FileParser::printError(const char* msg) {
-		const char chstr[] = {currentChar, '\0'};
-		const int chint = static_cast<int>(currentChar);
-		fprintf(
-			stderr,
-			"ERROR: %s\n    Parsing failed at line %ld, %ld (\"%s\")\n    Last parsed character: '%s' -- char code: %d\n    Expecting: %s\n",
-			msg, lineCount, linePosCount, currentToken.c_str(), (chint != EOF ? chstr : "EOF"), chint, getState()
-		);
+		index->built.store(false, memory_order_relaxed);
 	}
 
-} // anon namespace
+} // namespace gg
+
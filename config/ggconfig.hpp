@@ -1,20 +1,65 @@
-#include <boost/variant.hpp>
+#ifndef GG_CONFIG_HPP
+#define GG_CONFIG_HPP
+
+#include "ggconfig_file.hpp"
+#include "ggconfig_key.hpp"
+#include "ggconfig_parser.hpp"
+#include "ggconfig_stats.hpp"
+#include "ggconfig_table.hpp"
+#include "ggconfig_value.hpp"
+#include "ggconfig_view.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 
 namespace gg {
 
+	/* How ConfigStorage::parseFile() stores what it parses */
+	struct ParseOptions {
+		/*
+		Keep the file mapped and leave the values in it: strings point into the mapping instead of being copied,
+		escape sequences are resolved the first time a string is read.
+		Parsing only costs as much as finding where the values end. The file must not be truncated
+		while the storage is alive (replacing it, the way editors and ConfigHandle::watch() expect, is fine).
+		Numbers are still converted right away: the conversion is what tells if they're in range.
+		*/
+		bool lazy = false;
+
+		/*
+		Threads to parse big files with, 0 for one per core. The file is cut into chunks at line ends, and the chunks
+		are parsed at the same time and merged in file order, so the last definition still wins.
+		A cut that turns out to be inside a statement (a multi-line string, say) is noticed: from there on,
+		the file is parsed sequentially.
+		*/
+		unsigned threads = 1;
+	};
+
+
 	/*
 	A config file parser that stores identifier-value pairs in a table.
-	Keys must start with an alphabetic or an underscore char. They may also contain numbers.
+	It's a consumer of the event-driven parser in ggconfig_parser.hpp.
+	Keys must start with an alphabetic or an underscore char. They may also contain numbers,
+	and dots that separate the levels of a hierarchy (service.db.pool); levels can't be empty.
 
 	Supported types:
 		- string, 
 		- number (double),
 		- boolean.
 
+	Numbers:
+		- are parsed with std::from_chars, so they don't depend on the locale;
+		- end at whitespace or at the start of a comment ('#');
+		- inf and nan are accepted after a sign, hexadecimal notation is not.
+
 	Strings:
 		- must be enclosed in double quotes, like so: "my string value";
 		- support the following escape sequences: \\, \", \n, \t;
@@ -28,39 +73,207 @@ namespace gg {
 	*/
 	class ConfigStorage {
 	public:
-		/* State information (what the parser is expecting) */
-		enum class STATE {
-			INIT,     // initial state
-			LVAL,     // reading an identifier
-			RVAL,     // reading a value
-			STR,      // reading a string
-			NUM,
-			TRUE,     // reading a boolean
-			FALSE,    // reading a boolean
-			ASGN,     // reading an assignment operator
-			CMNT      // we're in a comment
-		};
-
 		/* Aliases */
-		using value_t = boost::variant<std::string, double, bool>;
-		using storage_t = std::unordered_map<std::string, value_t>;
+		using STATE = ParserState;
+		using value_t = ConfigValue;
+		using storage_t = FlatTable<value_t>;
 
 		/* Null element (returned by operator[] if it doesn't exist) */
-		static value_t null;
+		static const value_t null;
 
-		/* Key-value storage */
+		/* Key-value storage; long strings point into the arena below */
 		storage_t storage;
 
-		/* C-tors & d-tor */
+		/* C-tors & d-tor; not copyable, because the values point into the arena */
 		ConfigStorage();
+		ConfigStorage(const ConfigStorage&) = delete;
+		ConfigStorage& operator=(const ConfigStorage&) = delete;
+		ConfigStorage(ConfigStorage&&) = default;
+		ConfigStorage& operator=(ConfigStorage&&) = default;
 		virtual ~ConfigStorage();
 
-		/** Access operator */
-		value_t& operator[](const std::string& key);
-		const value_t& operator[](const std::string& key) const;
+		/*
+		Lookups take a string_view, so std::string, const char* and string literals
+		are all hashed and compared in place, without building a temporary std::string.
+		Lookups with a ConfigKey (see GG_KEY) skip the hashing altogether.
+		*/
+
+		/* nullptr if the key doesn't exist */
+		const value_t* find(std::string_view key) const noexcept {
+			return stats == nullptr ? storage.find(key) : findCounted(key, hashKey(key));
+		}
+		const value_t* find(const ConfigKey& key) const noexcept {
+			return stats == nullptr ? storage.find(key.name(), key.hash()) : findCounted(key.name(), key.hash());
+		}
+
+		/** Access operator; read-only, use set() to change values */
+		const value_t& operator[](std::string_view key) const noexcept { return orNull(find(key)); }
+		const value_t& operator[](const ConfigKey& key) const noexcept { return orNull(find(key)); }
+
+		/* Typed getters; return def if the key doesn't exist or holds another type. Key: string_view or ConfigKey */
+		template <typename Key>
+		std::string_view getString(const Key& key, std::string_view def = std::string_view()) const noexcept {
+			const value_t* elem = find(key);
+			return elem != nullptr ? elem->asString(def) : def;
+		}
+
+		template <typename Key>
+		double getDouble(const Key& key, double def = 0.0) const noexcept {
+			const value_t* elem = find(key);
+			return elem != nullptr ? elem->asNumber(def) : def;
+		}
+
+		template <typename Key>
+		bool getBool(const Key& key, bool def = false) const noexcept {
+			const value_t* elem = find(key);
+			return elem != nullptr ? elem->asBool(def) : def;
+		}
+
+		/*
+		Batched lookups: out[i] = (*this)[keys[i]] for every i < n, a null value if the key doesn't exist.
+		Every key of a batch is hashed and its slot prefetched before any of them is probed,
+		so the cache misses of the probes overlap instead of being paid one after the other.
+		Worth it for bursts of lookups in tables that don't fit in the cache.
+		*/
+		void getMany(const std::string_view* keys, size_t n, value_t* out) const noexcept;
+		void getMany(const ConfigKey* keys, size_t n, value_t* out) const noexcept;
+
+		/* Insert or overwrite a value */
+		void set(std::string_view key, std::string_view value);
+		void set(std::string_view key, const char* value) { set(key, std::string_view(value)); }
+		void set(std::string_view key, double value);
+		void set(std::string_view key, bool value);
+
+		/* Remove a key; returns false if it wasn't there */
+		bool erase(std::string_view key);
+
+		/* Bytes of the strings that don't fit inline; overwritten and erased values keep theirs until the storage is gone */
+		size_t stringBytes() const noexcept { return strings.bytesUsed(); }
+
+		/*
+		Sorted views, for walking the keys under a prefix: O(log n) to find them, then O(1) per key.
+		The index behind them is built by the first call, and rebuilt after the storage is modified
+		through set() or parseFile(); don't modify storage directly while using them.
+		*/
+
+		/* Every key */
+		ConfigView view() const;
+		/* The keys that start with prefix, relative to it: withPrefix("db_") has "db_pool" as "pool" */
+		ConfigView withPrefix(std::string_view prefix) const { return view().withPrefix(prefix); }
+		/* The keys under a dotted path, relative to it: subtree("db") has "db.pool" as "pool" */
+		ConfigView subtree(std::string_view path) const { return view().subtree(path); }
+
+		/*
+		Count lookups (find, operator[], the getters, getMany) and profile parsing into stats; nullptr detaches.
+		The stats must outlive the storage, or be detached first. Lookups through views aren't counted.
+		*/
+		void attachStats(ConfigStats* stats) noexcept { this->stats = stats; }
+		ConfigStats* attachedStats() const noexcept { return stats; }
 
 		/* Parse a config file (relative path) */
-		bool parseFile(const char* path);
+		bool parseFile(const char* path, const ParseOptions& options = ParseOptions());
+
+		/*
+		Parse a config that's already in memory (embedded in the binary, received, decompressed, ...).
+		Values are copied, unless options.lazy is set: then the buffer must outlive the storage, like a file would.
+		*/
+		bool parseBuffer(const char* data, size_t size, const ParseOptions& options = ParseOptions());
+		bool parseBuffer(std::string_view text, const ParseOptions& options = ParseOptions()) {
+			return parseBuffer(text.data(), text.size(), options);
+		}
+
+		/*
+		Reads the next part of a stream into buffer: returns the number of bytes read (at most capacity),
+		0 at the end of the stream, or a negative number on errors.
+		*/
+		using ReadFn = std::function<ptrdiff_t(char* buffer, size_t capacity)>;
+
+		/* Streams are read in blocks of this size */
+		static constexpr size_t STREAM_BLOCK_SIZE = 1024 * 1024;
+
+		/*
+		Parse a config from a stream (a pipe, a decompressor, ...) as it's read, one block at a time.
+		Each block is parsed up to its last complete statement, the rest is carried over to the next one,
+		so memory use is a block, or as much as the longest statement.
+		Values are always copied and parsed sequentially: ParseOptions don't apply.
+		*/
+		bool parseStream(const ReadFn& read, size_t blockSize = STREAM_BLOCK_SIZE);
+
+		/* Same, reading a file descriptor to its end: parseStream(STDIN_FILENO) */
+		bool parseStream(int fd);
+
+		/*
+		Write every entry into a binary snapshot (see ggconfig_snapshot.hpp), replacing the file atomically.
+		Open the snapshot with a ConfigSnapshot to query it in place, or load it back with loadSnapshot().
+		*/
+		bool saveSnapshot(const char* path) const;
+
+		/* Copy every entry of a snapshot into the storage, overwriting existing keys */
+		bool loadSnapshot(const char* path);
+
+		/*
+		Canonical text: one "key = value" line per entry, sorted by key (through view(), see above).
+		Strings are re-escaped and numbers written in their shortest form that reads back exactly,
+		so parsing the text gives back the same entries. Keys are written as they are:
+		keys set() that the parser wouldn't accept don't survive the round trip.
+		*/
+		std::string toText() const;
+		/* Same, appended to out */
+		void writeText(std::string& out) const;
+		/* Same, written to a file with a single write(), replacing it atomically */
+		bool saveText(const char* path) const;
+
+	private:
+		/* Feeds the parser's events into the storage */
+		class Loader;
+
+		/* Keys hashed and prefetched at a time by getMany(); about as many misses as a core keeps in flight */
+		static constexpr size_t LOOKUP_BATCH = 16;
+
+		/* Files smaller than this per thread are parsed sequentially */
+		static constexpr size_t MIN_CHUNK_SIZE = 1024 * 1024;
+
+		/* Owns the bytes of every string that doesn't fit inline */
+		StringArena strings;
+
+		/* Lazy parsing: the files the values point into, and the strings that are decoded on first access */
+		std::vector<std::unique_ptr<MappedFile>> sources;
+		std::deque<LazyString> lazyStrings;
+
+		/* Every key in sorted order; built on demand, safe to build from several readers at once */
+		struct PrefixIndex {
+			std::mutex lock;
+			std::atomic<bool> built{false};
+			std::vector<IndexedEntry> entries;
+		};
+
+		std::unique_ptr<PrefixIndex> index;
+
+		void invalidateIndex();
+
+		/* Instrumentation; not owned */
+		ConfigStats* stats;
+
+		const value_t* findCounted(std::string_view key, uint64_t hash) const noexcept {
+			const value_t* elem = storage.find(key, hash);
+			stats->recordLookup(key, hash, elem != nullptr);
+			return elem;
+		}
+
+		/* Chunks that were parsed in parallel and merged into this one; kept for the bytes their values point to */
+		std::vector<ConfigStorage> absorbed;
+
+		bool parse(const char* begin, const char* end, const ParseOptions& options);
+		bool parseParallel(const char* begin, const char* end, const ParseOptions& options, size_t numOfChunks, ParseProfile* profile);
+
+		/* Move every entry of a storage into this one, overwriting existing keys */
+		void absorb(ConfigStorage&& part);
+
+		static const value_t& orNull(const value_t* elem) noexcept {
+			return elem != nullptr ? *elem : null;
+		}
 	};
 
 }
+
+#endif // GG_CONFIG_HPP
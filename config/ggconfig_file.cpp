@@ -0,0 +1,96 @@
+#include "ggconfig_file.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+namespace gg {
+
+	MappedFile::MappedFile(const char* path, ACCESS access)
+		: data(nullptr)
+		, length(0)
+	{
+		const int fd = open(path, O_RDONLY);
+		if (fd == -1)
+			throw invalid_argument(string(path) + " could not be opened");
+
+		struct stat st;
+		if (fstat(fd, &st) == -1) {
+			close(fd);
+			throw invalid_argument(string(path) + " could not be opened");
+		}
+
+		length = static_cast<size_t>(st.st_size);
+
+		// mmap() refuses empty mappings; an empty file is simply an empty buffer
+		if (length != 0) {
+			void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (addr == MAP_FAILED) {
+				close(fd);
+				throw invalid_argument(string(path) + " could not be mapped");
+			}
+
+			madvise(addr, length, access == ACCESS::SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM);
+			data = static_cast<const char*>(addr);
+		}
+
+		// the mapping stays valid after the descriptor is closed
+		close(fd);
+	}
+
+
+	MappedFile::~MappedFile() {
+		if (data != nullptr)
+			munmap(const_cast<char*>(data), length);
+	}
+
+
+	bool writeFileAtomically(const char* path, string_view data) {
+		// a unique name next to the target: rename() stays within one file system, and concurrent writers don't collide
+		string tmpPath = string(path) + ".XXXXXX";
+
+		const int fd = mkstemp(&tmpPath[0]);
+		if (fd == -1) {
+			fprintf(stderr, "%s could not be opened for writing\n", path);
+			return false;
+		}
+
+		// mkstemp() creates the file as 0600; keep the mode of the file being replaced, or the usual 0644
+		struct stat st;
+		bool ok = fchmod(fd, stat(path, &st) == 0 ? (st.st_mode & 07777) : 0644) == 0;
+
+		// a single write() for regular files; the loop only matters if it's interrupted
+		const char* p = data.data();
+		size_t left = data.size();
+		while (ok && left != 0) {
+			const ssize_t written = write(fd, p, left);
+			ok = written > 0;
+			if (ok) {
+				p += written;
+				left -= static_cast<size_t>(written);
+			}
+		}
+
+		// the data has to reach the disk before the rename does, or a crash can leave an empty file under the name
+		ok = ok && fsync(fd) == 0;
+		ok = close(fd) == 0 && ok;
+		ok = ok && rename(tmpPath.c_str(), path) == 0;
+
+		if (!ok) {
+			fprintf(stderr, "%s could not be written\n", path);
+			unlink(tmpPath.c_str());
+		}
+
+		return ok;
+	}
+
+} // namespace gg
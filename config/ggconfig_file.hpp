@@ -0,0 +1,48 @@
+#ifndef GG_CONFIG_FILE_HPP
+#define GG_CONFIG_FILE_HPP
+
+#include <cstddef>
+#include <string_view>
+
+
+namespace gg {
+
+	/* Read-only memory mapping of a whole file */
+	class MappedFile {
+	public:
+		/* How the mapping is going to be read; passed on to the kernel as a hint */
+		enum class ACCESS {
+			SEQUENTIAL,
+			RANDOM
+		};
+
+		/*
+		Throws invalid_argument if the file could not be opened or mapped.
+		what() will return the requested file path.
+		*/
+		MappedFile(const char* path, ACCESS access = ACCESS::SEQUENTIAL);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		const char* begin() const noexcept { return data; }
+		const char* end() const noexcept { return data + length; }
+		size_t size() const noexcept { return length; }
+
+	private:
+		const char* data;
+		size_t length;
+	};
+
+
+	/*
+	Write the whole buffer to path through a uniquely named temp file that is synced, then renamed over path:
+	readers never see a half written file, and a crash leaves either the old or the new contents.
+	Errors are printed to stderr and false is returned.
+	*/
+	bool writeFileAtomically(const char* path, std::string_view data);
+
+} // namespace gg
+
+#endif // GG_CONFIG_FILE_HPP
@@ -0,0 +1,260 @@
+#include "ggconfig_handle.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <functional>
+#include <utility>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif // __linux__
+
+using namespace std;
+
+
+namespace gg {
+
+	//---------------------------------------------------
+	// ReadGuard
+	//---------------------------------------------------
+
+
+	ConfigHandle::ReadGuard::ReadGuard(ReadGuard&& other) noexcept
+		: slot(other.slot)
+		, storage(other.storage)
+	{
+		other.slot = nullptr;
+		other.storage = nullptr;
+	}
+
+
+	ConfigHandle::ReadGuard::~ReadGuard() {
+		if (slot != nullptr) {
+			slot->owner.store(thread::id(), memory_order_relaxed);
+			slot->epoch.store(0, memory_order_release);
+		}
+	}
+
+
+
+	//---------------------------------------------------
+	// ConfigHandle
+	//---------------------------------------------------
+
+
+	ConfigHandle::ConfigHandle()
+		: ConfigHandle(ConfigStorage())
+	{;}
+
+
+	ConfigHandle::ConfigHandle(ConfigStorage&& initial)
+		: current(new ConfigStorage(std::move(initial)))
+		, epoch(1)
+		, published(1)
+		, readers()
+		, overflow(nullptr)
+		, writeMutex()
+		, watcher()
+		, stopPipe{-1, -1}
+	{;}
+
+
+	ConfigHandle::~ConfigHandle() {
+		unwatch();
+		delete current.load(memory_order_acquire);
+
+		for (ReaderBlock* b = overflow.load(memory_order_acquire); b != nullptr; ) {
+			ReaderBlock* next = b->next;
+			delete b;
+			b = next;
+		}
+	}
+
+
+	bool ConfigHandle::enter(ReaderSlot& r) const noexcept {
+		uint64_t expected = 0;
+		if (r.epoch.load(memory_order_relaxed) != 0 || !r.epoch.compare_exchange_strong(expected, epoch.load(memory_order_seq_cst), memory_order_seq_cst))
+			return false;
+
+		r.owner.store(this_thread::get_id(), memory_order_relaxed);
+		return true;
+	}
+
+
+	ConfigHandle::ReadGuard ConfigHandle::read() const {
+		// start where this thread found a free slot last time; usually the first try succeeds
+		thread_local size_t hint = hash<thread::id>()(this_thread::get_id());
+
+		for (size_t n = 0, i = hint % MAX_READERS; n < MAX_READERS; ++n, i = (i + 1) % MAX_READERS) {
+			if (enter(readers[i])) {
+				hint = i;
+				// announced before loading the pointer: a writer either sees the slot or we see its new version
+				return ReadGuard(&readers[i], current.load(memory_order_seq_cst));
+			}
+		}
+
+		return readOverflow();
+	}
+
+
+	ConfigHandle::ReadGuard ConfigHandle::readOverflow() const {
+		for (ReaderBlock* b = overflow.load(memory_order_seq_cst); b != nullptr; b = b->next) {
+			for (auto& r: b->slots) {
+				if (enter(r))
+					return ReadGuard(&r, current.load(memory_order_seq_cst));
+			}
+		}
+
+		// every slot is taken: add a block with its first slot already ours
+		ReaderBlock* block = new ReaderBlock();
+		ReaderSlot& r = block->slots[0];
+		r.epoch.store(epoch.load(memory_order_seq_cst), memory_order_relaxed);
+		r.owner.store(this_thread::get_id(), memory_order_relaxed);
+
+		// pushed before loading the pointer, like a claimed slot: a writer either sees the block or we see its new version
+		ReaderBlock* head = overflow.load(memory_order_relaxed);
+		do {
+			block->next = head;
+		} while (!overflow.compare_exchange_weak(head, block, memory_order_seq_cst, memory_order_relaxed));
+
+		return ReadGuard(&r, current.load(memory_order_seq_cst));
+	}
+
+
+	void ConfigHandle::publish(ConfigStorage&& next) {
+		ConfigStorage* fresh = new ConfigStorage(std::move(next));
+
+		lock_guard<mutex> lock(writeMutex);
+
+		ConfigStorage* old = current.exchange(fresh, memory_order_seq_cst);
+		const uint64_t grace = epoch.fetch_add(1, memory_order_seq_cst) + 1;
+		published.fetch_add(1, memory_order_release);
+
+		// readers that entered before the new epoch may still hold the old version
+		const auto waitFor = [grace](const ReaderSlot& r) {
+			for (;;) {
+				const uint64_t e = r.epoch.load(memory_order_seq_cst);
+				if (e == 0 || e >= grace)
+					break;
+				assert(r.owner.load(memory_order_relaxed) != this_thread::get_id() && "publish() while holding a ReadGuard of the same handle");
+				this_thread::yield();
+			}
+		};
+
+		for (const auto& r: readers)
+			waitFor(r);
+		for (const ReaderBlock* b = overflow.load(memory_order_seq_cst); b != nullptr; b = b->next) {
+			for (const auto& r: b->slots)
+				waitFor(r);
+		}
+
+		delete old;
+	}
+
+
+	bool ConfigHandle::reload(const char* path) {
+		ConfigStorage next;
+		if (!next.parseFile(path))
+			return false;
+
+		publish(std::move(next));
+		return true;
+	}
+
+
+#ifdef __linux__
+
+	bool ConfigHandle::watch(const char* path) {
+		unwatch();
+
+		const string fullPath(path);
+		const size_t slash = fullPath.rfind('/');
+		const string dir = slash == string::npos ? "." : (slash == 0 ? "/" : fullPath.substr(0, slash));
+
+		// the directory is watched, so editors that replace the file (write a temp file, then rename) are noticed too
+		const int fd = inotify_init1(IN_CLOEXEC);
+		if (fd == -1 || inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+			fprintf(stderr, "%s could not be watched\n", path);
+			if (fd != -1)
+				close(fd);
+			return false;
+		}
+
+		if (pipe(stopPipe) == -1) {
+			fprintf(stderr, "%s could not be watched\n", path);
+			close(fd);
+			stopPipe[0] = stopPipe[1] = -1;
+			return false;
+		}
+
+		watcher = thread(&ConfigHandle::watchLoop, this, fullPath, fd);
+		return true;
+	}
+
+
+	void ConfigHandle::unwatch() {
+		if (!watcher.joinable())
+			return;
+
+		const char stop = 's';
+		if (write(stopPipe[1], &stop, 1) != 1)
+			perror("ConfigHandle::unwatch");
+		watcher.join();
+
+		close(stopPipe[0]);
+		close(stopPipe[1]);
+		stopPipe[0] = stopPipe[1] = -1;
+	}
+
+
+	void ConfigHandle::watchLoop(string path, int inotifyFd) {
+		const size_t slash = path.rfind('/');
+		const string name = slash == string::npos ? path : path.substr(slash + 1);
+
+		alignas(inotify_event) char buf[16 * 1024];
+		pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {stopPipe[0], POLLIN, 0}};
+
+		for (;;) {
+			if (poll(fds, 2, -1) == -1)
+				continue;
+			if (fds[1].revents != 0)
+				break;
+
+			const ssize_t len = ::read(inotifyFd, buf, sizeof(buf));
+			if (len <= 0)
+				continue;
+
+			// a burst of events for the file triggers a single reload
+			bool changed = false;
+			for (const char* p = buf; p < buf + len; ) {
+				const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+				if (ev->len != 0 && name == ev->name)
+					changed = true;
+				p += sizeof(inotify_event) + ev->len;
+			}
+
+			if (changed)
+				reload(path.c_str());
+		}
+
+		close(inotifyFd);
+	}
+
+#else
+
+	bool ConfigHandle::watch(const char* path) {
+		fprintf(stderr, "%s could not be watched: file watching is only supported on Linux\n", path);
+		return false;
+	}
+
+
+	void ConfigHandle::unwatch() {;}
+
+
+	void ConfigHandle::watchLoop(string, int) {;}
+
+#endif // __linux__
+
+} // namespace gg
@@ -0,0 +1,125 @@
+#ifndef GG_CONFIG_HANDLE_HPP
+#define GG_CONFIG_HANDLE_HPP
+
+#include "ggconfig.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+namespace gg {
+
+	/*
+	A config that many threads read while it's reloaded in the background.
+
+	Readers pin the current version with read(): one compare-exchange on a free reader slot and one load,
+	no locks and no waiting on writers. Past MAX_READERS live guards readers spill into overflow slots,
+	allocated on demand and kept until the handle is destroyed. Lookups through the guard are plain ConfigStorage lookups.
+
+	Writers parse the new version off to the side, publish it with a single atomic pointer swap,
+	then wait for a grace period -- until every reader that could still see the old version has released it --
+	before deleting the old version (epoch based RCU). Writers are serialized among themselves.
+
+	So a thread must not publish() or reload() while it holds a guard of the same handle: it would wait
+	for itself forever. Debug builds assert on that; a guard counts as held by the thread that took it.
+	*/
+	class ConfigHandle {
+		struct ReaderSlot;
+
+	public:
+		/* Number of read guards that can be alive at the same time without allocating overflow slots */
+		static constexpr size_t MAX_READERS = 128;
+
+		/* Keeps one version alive; don't keep it for long, it holds back reclamation */
+		class ReadGuard {
+		public:
+			ReadGuard(ReadGuard&& other) noexcept;
+			ReadGuard(const ReadGuard&) = delete;
+			ReadGuard& operator=(const ReadGuard&) = delete;
+			ReadGuard& operator=(ReadGuard&&) = delete;
+			~ReadGuard();
+
+			const ConfigStorage& operator*() const noexcept { return *storage; }
+			const ConfigStorage* operator->() const noexcept { return storage; }
+
+		private:
+			friend class ConfigHandle;
+
+			ReaderSlot* slot;
+			const ConfigStorage* storage;
+
+			ReadGuard(ReaderSlot* slot, const ConfigStorage* storage) noexcept
+				: slot(slot)
+				, storage(storage)
+			{;}
+		};
+
+		/* Starts with an empty storage */
+		ConfigHandle();
+		explicit ConfigHandle(ConfigStorage&& initial);
+
+		ConfigHandle(const ConfigHandle&) = delete;
+		ConfigHandle& operator=(const ConfigHandle&) = delete;
+
+		/* Stops the watcher; no guards may be alive */
+		virtual ~ConfigHandle();
+
+		/* Pin the current version */
+		ReadGuard read() const;
+
+		/* Publish a new version; blocks until the old one isn't read by anyone, then deletes it. Never call it while holding a guard */
+		void publish(ConfigStorage&& next);
+
+		/* Parse a file and publish it; on errors the current version is kept and false is returned */
+		bool reload(const char* path);
+
+		/* Number of versions published so far */
+		uint64_t version() const noexcept { return published.load(std::memory_order_acquire); }
+
+		/*
+		Reload the file in a background thread whenever it's written or replaced (inotify, Linux only).
+		Returns false if the watch could not be set up. Only one file is watched at a time.
+		*/
+		bool watch(const char* path);
+		void unwatch();
+
+	private:
+		/* One per cache line, so readers on different cores don't share lines */
+		struct alignas(64) ReaderSlot {
+			std::atomic<uint64_t> epoch{0};          // 0 = free, otherwise the epoch the reader entered in
+			std::atomic<std::thread::id> owner{};    // thread that took the guard; only checked by debug assertions
+		};
+
+		/* Overflow slots, pushed to the front of a list that only grows */
+		struct ReaderBlock {
+			ReaderSlot slots[MAX_READERS];
+			ReaderBlock* next = nullptr;
+		};
+
+		std::atomic<ConfigStorage*> current;
+		std::atomic<uint64_t> epoch;
+		std::atomic<uint64_t> published;
+		mutable ReaderSlot readers[MAX_READERS];
+		mutable std::atomic<ReaderBlock*> overflow;
+
+		/* Serializes writers */
+		std::mutex writeMutex;
+
+		/* Watcher */
+		std::thread watcher;
+		int stopPipe[2];
+
+		/* Take a free slot; false if it's already taken */
+		bool enter(ReaderSlot& r) const noexcept;
+		ReadGuard readOverflow() const;
+
+		void watchLoop(std::string path, int inotifyFd);
+	};
+
+} // namespace gg
+
+#endif // GG_CONFIG_HANDLE_HPP
@@ -0,0 +1,301 @@
+#include "ggconfig_incremental.hpp"
+#include "ggconfig_file.hpp"
+#include "ggconfig_scan.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+
+namespace {
+
+	/* Parser events of a part of the text: where its statements are, and every key's last value */
+	class RegionHandler: public gg::ConfigHandler {
+	public:
+		struct Definition {
+			uint32_t count;
+			gg::RawValue last;
+		};
+
+		/* Offsets are relative to base */
+		explicit RegionHandler(const char* base)
+			: base(base)
+			, statements()
+			, keys()
+		{;}
+
+		bool onValue(const vector<string_view>& keyList, const gg::RawValue& value) override {
+			const char* valueEnd = value.text.data() + value.text.size() + (value.type == gg::ConfigValue::TYPE::STRING ? 1 : 0);
+			statements.push_back(pair<size_t, size_t>(keyList.front().data() - base, valueEnd - base));
+
+			for (const auto& k: keyList) {
+				Definition& d = keys[k];
+				++d.count;
+				d.last = value;
+			}
+
+			return true;
+		}
+
+		const char* const base;
+		vector<pair<size_t, size_t>> statements;
+		gg::FlatTable<Definition> keys;
+	};
+
+
+	/* Last value of a few keys */
+	class KeyFilter: public gg::ConfigHandler {
+	public:
+		explicit KeyFilter(gg::FlatTable<gg::RawValue>& wanted)
+			: wanted(wanted)
+		{;}
+
+		bool onValue(const vector<string_view>& keys, const gg::RawValue& value) override {
+			for (const auto& k: keys) {
+				gg::RawValue* v = wanted.find(k);
+				if (v != nullptr)
+					*v = value;
+			}
+
+			return true;
+		}
+
+	private:
+		gg::FlatTable<gg::RawValue>& wanted;
+	};
+
+
+	void setRaw(gg::ConfigStorage& cs, string_view key, const gg::RawValue& value) {
+		switch (value.type) {
+		case gg::ConfigValue::TYPE::STRING:
+			if (value.escaped) {
+				string unescaped;
+				gg::unescape(value.text, unescaped);
+				cs.set(key, string_view(unescaped));
+			} else {
+				cs.set(key, value.text);
+			}
+			break;
+		case gg::ConfigValue::TYPE::NUMBER:
+			cs.set(key, value.number);
+			break;
+		case gg::ConfigValue::TYPE::BOOL:
+			cs.set(key, value.boolean);
+			break;
+		case gg::ConfigValue::TYPE::NONE:
+			break;
+		}
+	}
+
+
+	/*
+	A part that the parser left in the INIT state ends where a sequential parse of the whole text would be in INIT too,
+	unless its last token was cut short: that can't be if it ends with whitespace or a closing quote
+	*/
+	bool endsCleanly(const string& text, size_t pos) {
+		return pos == text.size() || pos == 0 || gg::scan::isSpace(text[pos - 1]) || text[pos - 1] == '"';
+	}
+
+} // anon namespace
+
+
+namespace gg {
+
+	IncrementalConfig::IncrementalConfig()
+		: current()
+		, stmts()
+		, cs()
+		, definitions()
+		, deadStringBytes(0)
+		, info()
+	{;}
+
+
+	IncrementalConfig::~IncrementalConfig() {;}
+
+
+	bool IncrementalConfig::update(string text) {
+		// the bytes that didn't change at either end
+		const size_t common = min(current.size(), text.size());
+		const size_t prefix = mismatch(current.begin(), current.begin() + common, text.begin()).first - current.begin();
+		const size_t suffix = mismatch(current.rbegin(), current.rbegin() + (common - prefix), text.rbegin()).first - current.rbegin();
+
+		const string removed = current.substr(prefix, current.size() - suffix - prefix);
+		current.swap(text);
+
+		if (apply(prefix, removed, current.size() - suffix - prefix))
+			return true;
+
+		current.swap(text);
+		return false;
+	}
+
+
+	bool IncrementalConfig::edit(size_t offset, size_t removed, string_view inserted) {
+		if (offset > current.size() || removed > current.size() - offset)
+			throw out_of_range("gg::IncrementalConfig::edit(): the edit is outside of the text");
+
+		// in place: only the bytes after the edit move
+		const string removedBytes = current.substr(offset, removed);
+		current.replace(offset, removed, inserted.data(), inserted.size());
+
+		if (apply(offset, removedBytes, inserted.size()))
+			return true;
+
+		current.replace(offset, inserted.size(), removedBytes);
+		return false;
+	}
+
+
+	bool IncrementalConfig::updateFile(const char* path) {
+		try {
+			MappedFile file(path);
+			return update(string(file.begin(), file.end()));
+		} catch (const invalid_argument& e) {
+			fprintf(stderr, "%s\n", e.what());
+			return false;
+		}
+	}
+
+
+	bool IncrementalConfig::apply(size_t offset, string_view removed, size_t insertedLength) {
+		const size_t n = stmts.size();
+		const size_t changedEnd = offset + removed.size();      // in the old text
+		const ptrdiff_t delta = static_cast<ptrdiff_t>(insertedLength) - static_cast<ptrdiff_t>(removed.size());
+
+		// the statements that overlap the change, or touch it: a token that ends right at it may go on
+		size_t i = partition_point(stmts.begin(), stmts.end(), [offset](const Statement& s) { return s.end < offset; }) - stmts.begin();
+		size_t j = partition_point(stmts.begin() + i, stmts.end(), [changedEnd](const Statement& s) { return s.begin <= changedEnd; }) - stmts.begin();
+		const size_t regionBegin = i > 0 ? stmts[i - 1].end : 0;
+
+		// the region ends at a statement that didn't change, if the parser agrees; otherwise it grows
+		RegionHandler fresh(current.data());
+		size_t regionEnd;
+		for (;;) {
+			regionEnd = j < n ? stmts[j].begin + delta : current.size();
+
+			fresh.statements.clear();
+			fresh.keys.clear();
+			const ParseResult result = parseConfigPart(current.data() + regionBegin, current.data() + regionEnd, fresh);
+
+			if (result.ok && result.state == ParserState::INIT && endsCleanly(current, regionEnd))
+				break;
+
+			if (j == n) {
+				// a real error: parse again, to print it with the right line number
+				RegionHandler ignored(current.data());
+				parseConfig(current.data() + regionBegin, current.data() + current.size(), ignored,
+				            1 + scan::countNewlines(current.data(), current.data() + regionBegin));
+				return false;
+			}
+
+			j = min(n, j + max<size_t>(1, j - i));
+		}
+
+		// the old region: the same bytes around the change, the removed ones in the middle
+		string oldRegion;
+		oldRegion.reserve(regionEnd - regionBegin - delta);
+		oldRegion.append(current, regionBegin, offset - regionBegin).append(removed);
+		oldRegion.append(current, offset + insertedLength, regionEnd - offset - insertedLength);
+
+		// what the replaced statements defined
+		RegionHandler old(oldRegion.data());
+		parseConfigPart(oldRegion.data(), oldRegion.data() + oldRegion.size(), old);
+
+		for (const auto& e: old.keys)
+			definitions[e.key()] -= e.value.count;
+		for (const auto& e: fresh.keys)
+			definitions[e.key()] += e.value.count;
+
+		// patch the table; the keys that are also defined elsewhere are resolved by a scan
+		FlatTable<RawValue> rescan;
+		size_t changedKeys = 0;
+
+		const auto resolve = [&](string_view key) {
+			uint32_t* count = definitions.find(key);
+			const RegionHandler::Definition* d = fresh.keys.find(key);
+
+			if (*count == 0) {
+				definitions.erase(key);
+				retire(key);
+				cs.erase(key);
+			} else if (d != nullptr && d->count == *count) {
+				retire(key);
+				setRaw(cs, key, d->last);
+			} else {
+				rescan[key] = RawValue();
+			}
+
+			++changedKeys;
+		};
+
+		for (const auto& e: fresh.keys)
+			resolve(e.key());
+		for (const auto& e: old.keys) {
+			if (fresh.keys.find(e.key()) == nullptr)
+				resolve(e.key());
+		}
+
+		if (!rescan.empty()) {
+			KeyFilter filter(rescan);
+			parseConfig(current.data(), current.data() + current.size(), filter);
+			for (const auto& e: rescan) {
+				retire(e.key());
+				setRaw(cs, e.key(), e.value);
+			}
+		}
+
+		compact();
+
+		// the statements after the region only moved
+		vector<Statement> replaced;
+		replaced.reserve(fresh.statements.size());
+		for (const auto& s: fresh.statements)
+			replaced.push_back(Statement{s.first, s.second});
+
+		stmts.erase(stmts.begin() + i, stmts.begin() + j);
+		stmts.insert(stmts.begin() + i, replaced.begin(), replaced.end());
+		for (size_t k = i + replaced.size(); k < stmts.size(); ++k) {
+			stmts[k].begin += delta;
+			stmts[k].end += delta;
+		}
+
+		info.reparsedBytes = regionEnd - regionBegin;
+		info.reparsedStatements = replaced.size();
+		info.changedKeys = changedKeys;
+		info.rescanned = !rescan.empty();
+		return true;
+	}
+
+
+	void IncrementalConfig::retire(string_view key) {
+		// short strings are inline, everything else was copied into the arena by setRaw()
+		const ConfigValue* value = cs.find(key);
+		if (value != nullptr && value->isString() && value->asString().size() > ConfigValue::INLINE_CAPACITY)
+			deadStringBytes += value->asString().size();
+	}
+
+
+	void IncrementalConfig::compact() {
+		if (deadStringBytes <= cs.stringBytes() - deadStringBytes)
+			return;
+
+		ConfigStorage next;
+		next.storage.reserve(cs.storage.size());
+		for (const auto& e: cs.storage) {
+			switch (e.value.type()) {
+			case ConfigValue::TYPE::STRING: next.set(e.key(), e.value.asString()); break;
+			case ConfigValue::TYPE::NUMBER: next.set(e.key(), e.value.asNumber()); break;
+			case ConfigValue::TYPE::BOOL:   next.set(e.key(), e.value.asBool());   break;
+			case ConfigValue::TYPE::NONE:   break;
+			}
+		}
+
+		cs = std::move(next);
+		deadStringBytes = 0;
+	}
+
+} // namespace gg
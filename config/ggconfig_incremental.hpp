@@ -0,0 +1,94 @@
+#ifndef GG_CONFIG_INCREMENTAL_HPP
+#define GG_CONFIG_INCREMENTAL_HPP
+
+#include "ggconfig.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace gg {
+
+	/*
+	A config that's edited while it's used, e.g. in an editor that re-validates on every change.
+
+	It keeps the text and where every statement is in it. When the text changes, the bytes that differ are found,
+	only the statements around them are parsed again, and the table is patched: a small edit in a big file
+	costs about as much as the statements it touches.
+
+	Keys that are also defined outside of the reparsed statements need to know which definition comes last:
+	for those the whole text is scanned (without being stored).
+
+	Replaced strings stay in the storage's arena; once they take more room than the live ones,
+	the storage is rebuilt, so memory stays proportional to the config however long it's edited.
+	*/
+	class IncrementalConfig {
+	public:
+		/* What the last update did */
+		struct UpdateInfo {
+			size_t reparsedBytes;
+			size_t reparsedStatements;
+			size_t changedKeys;
+			bool rescanned;       // keys defined more than once needed a scan of the whole text
+		};
+
+		IncrementalConfig();
+		IncrementalConfig(IncrementalConfig&&) = default;
+		IncrementalConfig& operator=(IncrementalConfig&&) = default;
+		virtual ~IncrementalConfig();
+
+		/*
+		Replace the whole text. The old and the new text are compared to find what changed.
+		On a syntax error the error is printed, false is returned and nothing changes.
+		*/
+		bool update(std::string text);
+
+		/* Replace `removed` bytes at `offset` with `inserted`; cheaper than update(), nothing has to be compared */
+		bool edit(size_t offset, size_t removed, std::string_view inserted);
+
+		/* update() with the contents of a file */
+		bool updateFile(const char* path);
+
+		const ConfigStorage& storage() const noexcept { return cs; }
+		const std::string& text() const noexcept { return current; }
+		size_t statements() const noexcept { return stmts.size(); }
+		const UpdateInfo& lastUpdate() const noexcept { return info; }
+
+	private:
+		/* Byte range of a statement, from its first key to the end of its value */
+		struct Statement {
+			size_t begin;
+			size_t end;
+		};
+
+		std::string current;
+		std::vector<Statement> stmts;
+		ConfigStorage cs;
+
+		/* Number of statements that define a key */
+		FlatTable<uint32_t> definitions;
+
+		/* Arena bytes of the strings that were overwritten or erased */
+		size_t deadStringBytes;
+
+		UpdateInfo info;
+
+		/*
+		Patch everything after the text changed: at `offset`, `removed` was replaced with `insertedLength` bytes.
+		Returns false on a syntax error; the text is then up to the caller to restore.
+		*/
+		bool apply(size_t offset, std::string_view removed, size_t insertedLength);
+
+		/* Account for the arena bytes of the key's value before it's replaced */
+		void retire(std::string_view key);
+
+		/* Copy the live entries into a fresh storage if the dead strings outweigh them */
+		void compact();
+	};
+
+} // namespace gg
+
+#endif // GG_CONFIG_INCREMENTAL_HPP
@@ -0,0 +1,61 @@
+#ifndef GG_CONFIG_KEY_HPP
+#define GG_CONFIG_KEY_HPP
+
+#include "ggconfig_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+
+namespace gg {
+
+	/*
+	A key name together with its hash.
+	The constructor is constexpr: keys built from literals in a constant expression are hashed
+	at compile time, and a lookup with them is a single probe without any hashing.
+	Use GG_KEY("name") (or gg::key<"name"> with C++20) to make sure that happens.
+	*/
+	class ConfigKey {
+	public:
+		constexpr explicit ConfigKey(std::string_view name) noexcept
+			: keyName(name)
+			, keyHash(hashKey(name))
+		{;}
+
+		constexpr std::string_view name() const noexcept { return keyName; }
+		constexpr uint64_t hash() const noexcept { return keyHash; }
+
+	private:
+		std::string_view keyName;
+		uint64_t keyHash;
+	};
+
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+
+	/* Literal usable as a template argument; only for gg::key */
+	template <size_t N>
+	struct KeyLiteral {
+		char data[N];
+
+		constexpr KeyLiteral(const char (&str)[N]) noexcept : data() {
+			for (size_t i = 0; i < N; ++i)
+				data[i] = str[i];
+		}
+	};
+
+	/* gg::key<"name"> -- a ConfigKey hashed at compile time */
+	template <KeyLiteral Name>
+	inline constexpr ConfigKey key = ConfigKey(std::string_view(Name.data, sizeof(Name.data) - 1));
+
+#endif
+
+} // namespace gg
+
+
+/* A gg::ConfigKey that is guaranteed to be hashed at compile time; the argument must be a string literal */
+#define GG_KEY(literal) ([]() noexcept { constexpr ::gg::ConfigKey ggKey_(literal); return ggKey_; }())
+
+
+#endif // GG_CONFIG_KEY_HPP
@@ -0,0 +1,623 @@
+#include "ggconfig_parser.hpp"
+#include "ggconfig_file.hpp"
+#include "ggconfig_scan.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <stdexcept>
+#include <system_error>
+
+using namespace std;
+
+
+namespace {
+
+	/*
+	Parses an in-memory buffer, without any thread-safety mechanics.
+	Tokens are never copied: keys and values are reported as views into the buffer.
+	*/
+	class Parser {
+	public:
+		/*
+		The buffer must outlive the parser.
+		A partial parser doesn't print errors, and may end in any state.
+		*/
+		Parser(gg::ConfigHandler& handler, const char* begin, const char* end, size_t firstLine, bool partial, gg::ParseProfile* profile);
+
+		/* Parse the whole buffer */
+		bool parse();
+
+		/* Get the current state of the parser */
+		gg::ParserState currentState() const noexcept { return state; }
+		const char* getState() const noexcept;
+
+		/* Print error to console */
+		void printError(const char* msg = "OK");
+
+	private:
+		using STATE = gg::ParserState;
+
+		/* Receives the assignments */
+		gg::ConfigHandler& handler;
+
+		/* Input buffer; cur points to the next unread char */
+		const char* cur;
+		const char* const end;
+
+		/* State vars */
+		STATE state, nextState;
+		/* Current char */
+		char currentChar;
+		/* Start of the key/value that is being parsed */
+		const char* tokenBegin;
+		/* The string that is being parsed contains escape sequences */
+		bool tokenEscaped;
+		/* The handler asked us to stop */
+		bool stopped;
+		/* Parsing a part of the input */
+		const bool partial;
+
+		/* The keys that are currently being declared */
+		vector<string_view> pendingKeys;
+
+		/* Position info */
+		const size_t firstLine;
+		size_t lineCount, linePosCount;
+
+		/* Profiling: the bytes before accounted are already counted for some state */
+		gg::ParseProfile* const profile;
+		const char* accounted;
+
+		/* Count the bytes consumed since the last call, up to upTo, for a state */
+		void account(STATE s, const char* upTo) {
+			if (profile != nullptr) {
+				profile->stateBytes[static_cast<size_t>(s)] += upTo - accounted;
+				accounted = upTo;
+			}
+		}
+
+		/* Get the next char from the buffer */
+		bool fetchChar() {
+			if (cur == end) {
+				currentChar = EOF;
+				return false;
+			}
+
+			currentChar = *cur++;
+
+			if (currentChar == '\n') {
+				lineCount++;
+				linePosCount = 0;
+			} else {
+				linePosCount++;
+			}
+
+			return true;
+		}
+
+		/* Consume [cur, to) in bulk; the range must not contain '\n' */
+		void skipInLine(const char* to) {
+			if (to != cur) {
+				linePosCount += to - cur;
+				currentChar = to[-1];
+				cur = to;
+			}
+		}
+
+		/* Consume [cur, to) in bulk, keeping the position info up to date */
+		void skipTo(const char* to) {
+			if (to == cur)
+				return;
+
+			const size_t lines = gg::scan::countNewlines(cur, to);
+			if (lines == 0) {
+				linePosCount += to - cur;
+			} else {
+				const char* lineStart = to;
+				while (lineStart[-1] != '\n')
+					--lineStart;
+
+				lineCount += lines;
+				linePosCount = to - lineStart;
+			}
+
+			currentChar = to[-1];
+			cur = to;
+		}
+
+		unsigned char getCurrentUchar() {
+			return static_cast<unsigned char>(currentChar);
+		}
+
+		/* Anything but the first char of a key; dots separate the levels of dotted keys */
+		static bool isIdentifierChar(char ch) {
+			return isalnum(static_cast<unsigned char>(ch)) || ch == '_' || ch == '.';
+		}
+
+		/* The key that ends right before the current char; false if it has an empty level */
+		bool pushPendingKey() {
+			const string_view key(tokenBegin, cur - 1 - tokenBegin);
+			if (key.back() == '.' || key.find("..") != string_view::npos)
+				return false;
+
+			pendingKeys.push_back(key);
+			return true;
+		}
+
+		/* Report the current keys to the handler; values without keys are dropped */
+		void emitValue(const gg::RawValue& value) {
+			if (!pendingKeys.empty()) {
+				stopped = !handler.onValue(pendingKeys, value);
+				pendingKeys.clear();
+			}
+		}
+
+		void emitString(string_view text);
+		void emitNumber(string_view text, double value);
+		void emitBool(string_view text, bool value);
+
+		bool handleEndOfBoolLiteralCandidate(bool value);
+		/* The literal turned out to be the start of an identifier: the current char belongs to it */
+		bool handleIsNotBoolLiteral() {
+			state = STATE::LVAL;
+			return cur == end && currentChar == EOF ? true : handleLvalState();
+		}
+
+		/* Parsing for the different states */
+		bool handleInitState();
+		bool handleLvalState();
+		bool handleRvalState();
+		bool handleStrState();
+		bool handleNumState();
+		bool handleTrueState();
+		bool handleFalseState();
+		bool handleAsgnState();
+	};
+
+} // anon namespace
+
+
+namespace gg {
+
+	ConfigHandler::~ConfigHandler() {;}
+
+
+	void unescape(string_view raw, string& out) {
+		out.reserve(out.size() + raw.size());
+
+		for (size_t i = 0; i < raw.size(); ++i) {
+			if (raw[i] != '\\' || i + 1 == raw.size()) {
+				out.append(1, raw[i]);
+				continue;
+			}
+
+			switch (raw[++i]) {
+			case '\\':
+			case '"':
+				out.append(1, raw[i]);
+				break;
+
+			case 'n':
+				out.append(1, '\n');
+				break;
+
+			case 't':
+				out.append(1, '\t');
+				break;
+
+			default:
+				out.append(1, '\\');
+				out.append(1, raw[i]);
+				break;
+			}
+		}
+	}
+
+
+	const char* parserStateName(ParserState state) noexcept {
+		switch (state) {
+		case ParserState::INIT:
+			return "INIT";
+		case ParserState::LVAL:
+			return "IDENTIFIER";
+		case ParserState::RVAL:
+			return "VALUE";
+		case ParserState::STR:
+			return "STRING";
+		case ParserState::TRUE:
+			return "TRUE";
+		case ParserState::FALSE:
+			return "FALSE";
+		case ParserState::NUM:
+			return "NUMBER";
+		case ParserState::ASGN:
+			return "ASSIGN";
+		case ParserState::CMNT:
+			return "COMMENT";
+		}
+
+		return "UNKNOWN";
+	}
+
+
+	bool parseConfig(const char* begin, const char* end, ConfigHandler& handler, size_t firstLine, ParseProfile* profile) {
+		::Parser p(handler, begin, end, firstLine, false, profile);
+		return p.parse();
+	}
+
+
+	ParseResult parseConfigPart(const char* begin, const char* end, ConfigHandler& handler, ParseProfile* profile) {
+		::Parser p(handler, begin, end, 1, true, profile);
+
+		ParseResult result;
+		result.ok = p.parse();
+		result.state = p.currentState();
+		return result;
+	}
+
+
+	bool parseConfigFile(const char* path, ConfigHandler& handler) {
+		try {
+			MappedFile file(path);
+			return parseConfig(file.begin(), file.end(), handler);
+		} catch (const invalid_argument& e) {
+			fprintf(stderr, "%s\n", e.what());
+			return false;
+		}
+	}
+
+} // namespace gg
+
+
+namespace {
+
+	Parser::Parser(gg::ConfigHandler& handler, const char* begin, const char* end, size_t firstLine, bool partial, gg::ParseProfile* profile)
+		: handler(handler)
+		, cur(begin)
+		, end(end)
+		, state()
+		, nextState()
+		, currentChar()
+		, tokenBegin(begin)
+		, tokenEscaped(false)
+		, stopped(false)
+		, partial(partial)
+		, pendingKeys()
+		, firstLine(firstLine)
+		, lineCount()
+		, linePosCount()
+		, profile(profile)
+		, accounted(begin)
+	{;}
+
+
+	bool Parser::parse() {
+		state = STATE::INIT;
+		nextState = STATE::INIT;
+
+		lineCount = firstLine;
+		linePosCount = 0;
+		currentChar = '?';
+
+		while (fetchChar()) {
+			// the bytes of an iteration count for the state it started in
+			const STATE current = state;
+
+			switch (state) {
+			case STATE::INIT:
+				if (!handleInitState()) {
+					printError("Unexpected character encountered.");
+					return false;
+				}
+				break;
+			case STATE::LVAL:
+				if (!handleLvalState()) {
+					printError("Identifier expected.");
+					return false;
+				}
+				break;
+			case STATE::RVAL:
+				if (!handleRvalState()) {
+					printError("Value expected.");
+					return false;
+				}
+				break;
+			case STATE::STR:
+				if (!handleStrState()) {
+					printError("String expected.");
+					return false;
+				}
+				break;
+			case STATE::NUM:
+				if (!handleNumState()) {
+					printError("Number expected.");
+					return false;
+				}
+				break;
+			case STATE::TRUE:
+				if (!handleTrueState()) {
+					printError("\"true\" expected.");
+					return false;
+				}
+				break;
+			case STATE::FALSE:
+				if (!handleFalseState()) {
+					printError("\"false\" expected.");
+					return false;
+				}
+				break;
+			case STATE::ASGN:
+				if (!handleAsgnState()) {
+					printError("Assignment operator (\"=\") expected.");
+					return false;
+				}
+				break;
+			case STATE::CMNT:
+				if (currentChar == '\n') {
+					state = nextState;
+					nextState = STATE::INIT;
+				} else {
+					skipInLine(gg::scan::findNewline(cur, end));
+				}
+				break;
+			}
+
+			account(current, cur);
+
+			if (stopped)
+				return true;
+		}
+
+		if (state == STATE::INIT || partial) {
+			return true;
+		} else {
+			printError("Parsing finished in an unexpected state");
+			return false;
+		}
+	}
+
+
+	void Parser::emitString(string_view text) {
+		gg::RawValue v;
+		v.type = gg::ConfigValue::TYPE::STRING;
+		v.text = text;
+		v.escaped = tokenEscaped;
+		v.number = 0.0;
+		v.boolean = false;
+		emitValue(v);
+	}
+
+
+	void Parser::emitNumber(string_view text, double value) {
+		gg::RawValue v;
+		v.type = gg::ConfigValue::TYPE::NUMBER;
+		v.text = text;
+		v.escaped = false;
+		v.number = value;
+		v.boolean = false;
+		emitValue(v);
+	}
+
+
+	void Parser::emitBool(string_view text, bool value) {
+		gg::RawValue v;
+		v.type = gg::ConfigValue::TYPE::BOOL;
+		v.text = text;
+		v.escaped = false;
+		v.number = 0.0;
+		v.boolean = value;
+		emitValue(v);
+	}
+
+
+	bool Parser::handleInitState() {
+		if (!isspace(getCurrentUchar())) {
+			if (isdigit(getCurrentUchar()) || currentChar == '-' || currentChar == '+' || currentChar == '.') {
+				return handleNumState();
+			} else if (isalpha(getCurrentUchar()) || currentChar == '_') {
+				tokenBegin = cur - 1;
+
+				switch (currentChar) {
+				case 't':
+					return handleTrueState();
+				case 'f':
+					return handleFalseState();
+				default:
+					state = STATE::LVAL;
+					break;
+				}
+			} else if (currentChar == '#') {
+				state = STATE::CMNT;
+				nextState = STATE::INIT;
+			} else {
+				return false;
+			}
+		} else {
+			skipTo(gg::scan::skipSpace(cur, end));
+		}
+
+		return true;
+	}
+
+
+	bool Parser::handleLvalState() {
+		if (isIdentifierChar(currentChar)) {
+			// the rest of the identifier in one go
+			const char* identEnd = cur;
+			while (identEnd != end && isIdentifierChar(*identEnd))
+				++identEnd;
+			skipInLine(identEnd);
+		} else if (isspace(getCurrentUchar())) {
+			if (!pushPendingKey())
+				return false;
+			state = STATE::ASGN;
+		} else if (currentChar == '=') {
+			if (!pushPendingKey())
+				return false;
+			state = STATE::RVAL;
+		} else if (currentChar == '#') {
+			if (!pushPendingKey())
+				return false;
+			state = STATE::CMNT;
+			nextState = STATE::ASGN;
+		} else {
+			return false;
+		}
+
+		return true;
+	}
+
+
+	bool Parser::handleRvalState() {
+		// checked first: a failed number leaves its last char in currentChar
+		if (currentChar == '"') {
+			state = STATE::STR;
+			tokenBegin = cur;
+			tokenEscaped = false;
+		} else if (handleInitState()) {
+			if (state == STATE::CMNT)
+				nextState = STATE::RVAL;
+		} else {
+			return false;
+		}
+
+		return true;
+	}
+
+
+	bool Parser::handleStrState() {
+		if (currentChar == '\\') {
+			// the escaped char is skipped, so an escaped quote doesn't end the string
+			tokenEscaped = true;
+			if (!fetchChar())
+				return false;
+		} else if (currentChar == '"') {
+			emitString(string_view(tokenBegin, cur - 1 - tokenBegin));
+			state = STATE::INIT;
+		} else {
+			// skip everything up to the next special char in one go
+			skipTo(gg::scan::findQuoteOrBackslash(cur, end));
+		}
+
+		return true;
+	}
+
+
+	bool Parser::handleNumState() {
+		account(state, cur - 1);
+		state = STATE::NUM;
+
+		// the token is parsed in place: it ends at whitespace or at the start of a comment
+		tokenBegin = cur - 1;
+		const char* tokenEnd = cur;
+		while (tokenEnd != end && !gg::scan::isSpace(*tokenEnd) && *tokenEnd != '#')
+			++tokenEnd;
+		skipInLine(tokenEnd);
+
+		// stod() used to accept a leading '+', from_chars() doesn't
+		const char* first = tokenBegin;
+		if (*first == '+' && tokenEnd - first > 1 && first[1] != '+' && first[1] != '-')
+			++first;
+
+		double val;
+		const auto result = from_chars(first, tokenEnd, val);
+
+		if (result.ec != errc() || result.ptr != tokenEnd)
+			return false;
+
+		emitNumber(string_view(tokenBegin, tokenEnd - tokenBegin), val);
+		account(STATE::NUM, tokenEnd);
+		state = STATE::INIT;
+		return true;
+	}
+
+
+	// candidate
+	bool Parser::handleEndOfBoolLiteralCandidate(bool value) {
+		if (cur != end) {
+			char ch = *cur;
+
+			if (!isspace(static_cast<unsigned char>(ch)) && ch != '#') {
+				if (ch != '=') {
+					state = STATE::LVAL;
+					return true;
+				}
+
+				fetchChar();
+				return false;
+			}
+		}
+
+		account(state, cur);
+		state = STATE::INIT;
+		emitBool(string_view(tokenBegin, cur - tokenBegin), value);
+		return true;
+	}
+
+
+	bool Parser::handleTrueState() {
+		account(state, cur - 1);
+		state = STATE::TRUE;
+
+		if (!fetchChar() || currentChar != 'r') return handleIsNotBoolLiteral();
+		if (!fetchChar() || currentChar != 'u') return handleIsNotBoolLiteral();
+		if (!fetchChar() || currentChar != 'e') return handleIsNotBoolLiteral();
+
+		return handleEndOfBoolLiteralCandidate(true);
+	}
+
+
+	bool Parser::handleFalseState() {
+		account(state, cur - 1);
+		state = STATE::FALSE;
+
+		if (!fetchChar() || currentChar != 'a') return handleIsNotBoolLiteral();
+		if (!fetchChar() || currentChar != 'l') return handleIsNotBoolLiteral();
+		if (!fetchChar() || currentChar != 's') return handleIsNotBoolLiteral();
+		if (!fetchChar() || currentChar != 'e') return handleIsNotBoolLiteral();
+
+		return handleEndOfBoolLiteralCandidate(false);
+	}
+
+
+	bool Parser::handleAsgnState() {
+		if (!isspace(getCurrentUchar())) {
+			if (currentChar == '=') {
+				state = STATE::RVAL;
+			} else if (currentChar == '#') {
+				state = STATE::CMNT;
+				nextState = STATE::ASGN;
+			} else {
+				return false;
+			}
+		} else {
+			skipTo(gg::scan::skipSpace(cur, end));
+		}
+
+		return true;
+	}
+
+
+	const char* Parser::getState() const noexcept {
+		return gg::parserStateName(state);
+	}
+
+
+	void Parser::printError(const char* msg) {
+		if (partial)
+			return;
+
+		// the token that was being parsed, up to the current char (only its start if it's long)
+		const int tokenLength = tokenBegin <= cur ? static_cast<int>(min<ptrdiff_t>(cur - tokenBegin, 64)) : 0;
+
+		const char chstr[] = {currentChar, '\0'};
+		const int chint = static_cast<int>(currentChar);
+		fprintf(
+			stderr,
+			"ERROR: %s\n    Parsing failed at line %ld, %ld (\"%.*s\")\n    Last parsed character: '%s' -- char code: %d\n    Expecting: %s\n",
+			msg, lineCount, linePosCount, tokenLength, tokenBegin, (chint != EOF ? chstr : "EOF"), chint, getState()
+		);
+	}
+
+} // anon namespace
@@ -0,0 +1,150 @@
+#ifndef GG_CONFIG_PARSER_HPP
+#define GG_CONFIG_PARSER_HPP
+
+#include "ggconfig_value.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace gg {
+
+	/* State information (what the parser is expecting) */
+	enum class ParserState {
+		INIT,     // initial state
+		LVAL,     // reading an identifier
+		RVAL,     // reading a value
+		STR,      // reading a string
+		NUM,
+		TRUE,     // reading a boolean
+		FALSE,    // reading a boolean
+		ASGN,     // reading an assignment operator
+		CMNT      // we're in a comment; keep it last, PARSER_STATE_COUNT follows it
+	};
+
+	/* Number of parser states */
+	constexpr size_t PARSER_STATE_COUNT = static_cast<size_t>(ParserState::CMNT) + 1;
+
+	/* Name of a state, as error messages and reports print it */
+	const char* parserStateName(ParserState state) noexcept;
+
+
+	/*
+	Where a parse spent its input: the bytes consumed in each state.
+	Numbers and boolean literals count for their own state, even though they're read in one go from INIT or RVAL.
+	*/
+	struct ParseProfile {
+		uint64_t stateBytes[PARSER_STATE_COUNT] = {};
+
+		ParseProfile& operator+=(const ParseProfile& other) noexcept {
+			for (size_t i = 0; i < PARSER_STATE_COUNT; ++i)
+				stateBytes[i] += other.stateBytes[i];
+			return *this;
+		}
+	};
+
+
+	/* A value as it appears in the input */
+	struct RawValue {
+		ConfigValue::TYPE type;
+
+		/*
+		View into the input: the string between the quotes (escape sequences not resolved),
+		the number token, or the boolean literal
+		*/
+		std::string_view text;
+
+		/* Strings only: text contains escape sequences, use unescape() to get the value */
+		bool escaped;
+
+		/* Decoded numbers and booleans */
+		double number;
+		bool boolean;
+	};
+
+
+	/* Resolve the escape sequences of a raw string, appending the result to out */
+	void unescape(std::string_view raw, std::string& out);
+
+
+	/*
+	Receives the assignments of a config, in input order.
+	The views passed to the handler point into the input buffer: they're only valid while it is.
+	*/
+	class ConfigHandler {
+	public:
+		virtual ~ConfigHandler();
+
+		/*
+		Called once per assignment, with every key of a chain: a = b = 1 is reported as ({a, b}, 1).
+		Return false to stop parsing.
+		*/
+		virtual bool onValue(const std::vector<std::string_view>& keys, const RawValue& value) = 0;
+	};
+
+
+	/*
+	Event-driven parsing: reports every assignment to the handler as it's parsed, nothing is stored.
+	Memory use doesn't depend on the size of the input.
+
+	Syntax errors are printed to stderr and false is returned; firstLine is the line number of begin in them.
+	Stopping early from the handler is not an error.
+	If a profile is given, the bytes consumed in each state are added to it.
+	*/
+	bool parseConfig(const char* begin, const char* end, ConfigHandler& handler, size_t firstLine = 1, ParseProfile* profile = nullptr);
+
+
+	/* How parsing a part of an input ended */
+	struct ParseResult {
+		bool ok;              // no syntax errors
+		ParserState state;    // INIT if the part ended between two statements
+	};
+
+	/*
+	Parse a part of an input, for callers that split it up themselves.
+	The part is parsed as if a statement started at begin; nothing is printed, ending in the middle of a statement is not an error.
+	*/
+	ParseResult parseConfigPart(const char* begin, const char* end, ConfigHandler& handler, ParseProfile* profile = nullptr);
+
+	/* Same, for a file; it's memory mapped and read sequentially */
+	bool parseConfigFile(const char* path, ConfigHandler& handler);
+
+
+	/* Wraps a callable bool f(const std::vector<std::string_view>& keys, const RawValue& value) */
+	template <typename F>
+	class CallbackHandler: public ConfigHandler {
+	public:
+		explicit CallbackHandler(F f)
+			: f(std::move(f))
+		{;}
+
+		bool onValue(const std::vector<std::string_view>& keys, const RawValue& value) override {
+			return f(keys, value);
+		}
+
+	private:
+		F f;
+	};
+
+
+	/* Callback versions of the above */
+	template <typename F, typename = std::enable_if_t<!std::is_base_of<ConfigHandler, std::decay_t<F>>::value>>
+	bool parseConfig(const char* begin, const char* end, F&& f) {
+		CallbackHandler<std::decay_t<F>> handler(std::forward<F>(f));
+		return parseConfig(begin, end, static_cast<ConfigHandler&>(handler));
+	}
+
+	template <typename F, typename = std::enable_if_t<!std::is_base_of<ConfigHandler, std::decay_t<F>>::value>>
+	bool parseConfigFile(const char* path, F&& f) {
+		CallbackHandler<std::decay_t<F>> handler(std::forward<F>(f));
+		return parseConfigFile(path, static_cast<ConfigHandler&>(handler));
+	}
+
+} // namespace gg
+
+#endif // GG_CONFIG_PARSER_HPP
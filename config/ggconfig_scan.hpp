@@ -0,0 +1,182 @@
+#ifndef GG_CONFIG_SCAN_HPP
+#define GG_CONFIG_SCAN_HPP
+
+/*
+Bulk scanning routines used by the config parser to skip whitespace and comments,
+and to copy string bodies without going through the state machine one char at a time.
+
+Every routine takes a [p, end) range and returns a pointer in [p, end].
+The vectorized versions are picked at compile time (AVX2 if enabled, then SSE2).
+Define GGCONFIG_NO_SIMD to force the scalar fallback.
+*/
+
+#include <cstddef>
+
+#if !defined(GGCONFIG_NO_SIMD) && defined(__AVX2__)
+#	define GGCONFIG_SCAN_AVX2
+#	include <immintrin.h>
+#elif !defined(GGCONFIG_NO_SIMD) && defined(__SSE2__)
+#	define GGCONFIG_SCAN_SSE2
+#	include <emmintrin.h>
+#endif
+
+
+namespace gg {
+namespace scan {
+
+	/* Same set as isspace() in the "C" locale */
+	inline bool isSpace(char c) noexcept {
+		return c == ' ' || static_cast<unsigned char>(c - '\t') < 5;
+	}
+
+
+	/* Reference implementations; also used for the tails of the vectorized loops */
+	namespace scalar {
+
+		/* Pointer to the first '\n', or end */
+		inline const char* findNewline(const char* p, const char* end) noexcept {
+			while (p != end && *p != '\n')
+				++p;
+			return p;
+		}
+
+		/* Pointer to the first '"' or '\\', or end */
+		inline const char* findQuoteOrBackslash(const char* p, const char* end) noexcept {
+			while (p != end && *p != '"' && *p != '\\')
+				++p;
+			return p;
+		}
+
+		/* Pointer to the first char that is not whitespace, or end */
+		inline const char* skipSpace(const char* p, const char* end) noexcept {
+			while (p != end && isSpace(*p))
+				++p;
+			return p;
+		}
+
+		/* Number of '\n' chars in the range */
+		inline size_t countNewlines(const char* p, const char* end) noexcept {
+			size_t count = 0;
+			for (; p != end; ++p)
+				count += (*p == '\n');
+			return count;
+		}
+
+	} // namespace scalar
+
+
+#if defined(GGCONFIG_SCAN_AVX2)
+
+	namespace simd {
+
+		using vec_t = __m256i;
+		constexpr size_t WIDTH = 32;
+
+		inline vec_t load(const char* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const vec_t*>(p)); }
+		inline vec_t splat(char c) noexcept { return _mm256_set1_epi8(c); }
+		inline unsigned eqMask(vec_t v, vec_t c) noexcept { return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, c))); }
+
+		inline unsigned spaceMask(vec_t v) noexcept {
+			// (c - '\t') <= 4 as unsigned bytes, or c == ' '
+			const vec_t shifted = _mm256_sub_epi8(v, splat('\t'));
+			const vec_t ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, splat(4)), shifted);
+			return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(ctrl, _mm256_cmpeq_epi8(v, splat(' ')))));
+		}
+
+		constexpr unsigned FULL = 0xFFFFFFFFu;
+
+	} // namespace simd
+
+#elif defined(GGCONFIG_SCAN_SSE2)
+
+	namespace simd {
+
+		using vec_t = __m128i;
+		constexpr size_t WIDTH = 16;
+
+		inline vec_t load(const char* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const vec_t*>(p)); }
+		inline vec_t splat(char c) noexcept { return _mm_set1_epi8(c); }
+		inline unsigned eqMask(vec_t v, vec_t c) noexcept { return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, c))); }
+
+		inline unsigned spaceMask(vec_t v) noexcept {
+			// (c - '\t') <= 4 as unsigned bytes, or c == ' '
+			const vec_t shifted = _mm_sub_epi8(v, splat('\t'));
+			const vec_t ctrl = _mm_cmpeq_epi8(_mm_min_epu8(shifted, splat(4)), shifted);
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(ctrl, _mm_cmpeq_epi8(v, splat(' ')))));
+		}
+
+		constexpr unsigned FULL = 0xFFFFu;
+
+	} // namespace simd
+
+#endif
+
+
+#if defined(GGCONFIG_SCAN_AVX2) || defined(GGCONFIG_SCAN_SSE2)
+
+	inline const char* findNewline(const char* p, const char* end) noexcept {
+		const simd::vec_t nl = simd::splat('\n');
+
+		for (; static_cast<size_t>(end - p) >= simd::WIDTH; p += simd::WIDTH) {
+			const unsigned mask = simd::eqMask(simd::load(p), nl);
+			if (mask != 0)
+				return p + __builtin_ctz(mask);
+		}
+
+		return scalar::findNewline(p, end);
+	}
+
+
+	inline const char* findQuoteOrBackslash(const char* p, const char* end) noexcept {
+		const simd::vec_t quote = simd::splat('"');
+		const simd::vec_t bslash = simd::splat('\\');
+
+		for (; static_cast<size_t>(end - p) >= simd::WIDTH; p += simd::WIDTH) {
+			const simd::vec_t v = simd::load(p);
+			const unsigned mask = simd::eqMask(v, quote) | simd::eqMask(v, bslash);
+			if (mask != 0)
+				return p + __builtin_ctz(mask);
+		}
+
+		return scalar::findQuoteOrBackslash(p, end);
+	}
+
+
+	inline const char* skipSpace(const char* p, const char* end) noexcept {
+		// most runs are a single '\n' or an indentation, so don't pay for a vector load up front
+		if (p == end || !isSpace(*p))
+			return p;
+
+		for (; static_cast<size_t>(end - p) >= simd::WIDTH; p += simd::WIDTH) {
+			const unsigned mask = simd::spaceMask(simd::load(p)) ^ simd::FULL;
+			if (mask != 0)
+				return p + __builtin_ctz(mask);
+		}
+
+		return scalar::skipSpace(p, end);
+	}
+
+
+	inline size_t countNewlines(const char* p, const char* end) noexcept {
+		const simd::vec_t nl = simd::splat('\n');
+		size_t count = 0;
+
+		for (; static_cast<size_t>(end - p) >= simd::WIDTH; p += simd::WIDTH)
+			count += static_cast<size_t>(__builtin_popcount(simd::eqMask(simd::load(p), nl)));
+
+		return count + scalar::countNewlines(p, end);
+	}
+
+#else
+
+	using scalar::findNewline;
+	using scalar::findQuoteOrBackslash;
+	using scalar::skipSpace;
+	using scalar::countNewlines;
+
+#endif
+
+} // namespace scan
+} // namespace gg
+
+#endif // GG_CONFIG_SCAN_HPP
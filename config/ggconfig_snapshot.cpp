@@ -0,0 +1,239 @@
+#include "ggconfig_snapshot.hpp"
+#include "ggconfig.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+
+namespace gg {
+
+	//---------------------------------------------------
+	// Writing (ConfigStorage)
+	//---------------------------------------------------
+
+
+	bool ConfigStorage::saveSnapshot(const char* path) const {
+		using snapshot::Header;
+		using snapshot::Slot;
+
+		uint64_t slotCount = 8;
+		while (slotCount < 2 * storage.size())
+			slotCount *= 2;
+		const uint64_t mask = slotCount - 1;
+
+		const uint64_t indexOffset = sizeof(Header);
+		const uint64_t poolOffset = indexOffset + slotCount * sizeof(Slot);
+
+		// the file is assembled in memory, then written in one go
+		string out(poolOffset, '\0');
+		vector<Slot> slots(slotCount);
+
+		uint64_t entryCount = 0;
+		for (const auto& e: storage) {
+			// null values aren't stored: nothing of them may reach the pool or the count
+			if (e.value.type() == value_t::TYPE::NONE)
+				continue;
+
+			Slot s = Slot();
+			s.hash = snapshot::slotHash(hashKey(e.key()));
+			s.keyOffset = out.size() - poolOffset;
+			s.keyLength = static_cast<uint32_t>(e.key().size());
+			out.append(e.key());
+
+			switch (e.value.type()) {
+			case value_t::TYPE::STRING: {
+					const string_view str = e.value.asString();
+					s.type = snapshot::SLOT_STRING;
+					s.payload = out.size() - poolOffset;
+					s.valueLength = static_cast<uint32_t>(str.size());
+					out.append(str);
+				} break;
+			case value_t::TYPE::NUMBER: {
+					const double number = e.value.asNumber();
+					s.type = snapshot::SLOT_NUMBER;
+					memcpy(&s.payload, &number, sizeof(number));
+				} break;
+			case value_t::TYPE::BOOL:
+				s.type = snapshot::SLOT_BOOL;
+				s.payload = e.value.asBool();
+				break;
+			case value_t::TYPE::NONE:
+				break;
+			}
+
+			uint64_t idx = s.hash & mask;
+			while (slots[idx].type != snapshot::SLOT_EMPTY)
+				idx = (idx + 1) & mask;
+			slots[idx] = s;
+			++entryCount;
+		}
+
+		Header h = Header();
+		memcpy(h.magic, snapshot::MAGIC, sizeof(h.magic));
+		h.version = snapshot::VERSION;
+		h.byteOrder = snapshot::ENDIAN_TAG;
+		h.entryCount = entryCount;
+		h.slotCount = slotCount;
+		h.indexOffset = indexOffset;
+		h.poolOffset = poolOffset;
+		h.poolSize = out.size() - poolOffset;
+
+		memcpy(&out[indexOffset], slots.data(), slotCount * sizeof(Slot));
+		h.checksum = hashKey(string_view(out.data() + indexOffset, out.size() - indexOffset));
+		memcpy(&out[0], &h, sizeof(h));
+
+		return writeFileAtomically(path, out);
+	}
+
+
+	bool ConfigStorage::loadSnapshot(const char* path) {
+		ConfigSnapshot snap;
+		if (!snap.open(path))
+			return false;
+
+		snap.forEach([this](string_view key, const value_t& value) {
+			switch (value.type()) {
+			case value_t::TYPE::STRING: set(key, value.asString()); break;
+			case value_t::TYPE::NUMBER: set(key, value.asNumber()); break;
+			case value_t::TYPE::BOOL:   set(key, value.asBool());   break;
+			case value_t::TYPE::NONE:   break;
+			}
+		});
+
+		return true;
+	}
+
+
+
+	//---------------------------------------------------
+	// Reading (ConfigSnapshot)
+	//---------------------------------------------------
+
+
+	ConfigSnapshot::ConfigSnapshot() noexcept
+		: file()
+		, header(nullptr)
+		, slots(nullptr)
+		, pool(nullptr)
+	{;}
+
+
+	ConfigSnapshot::ConfigSnapshot(ConfigSnapshot&& other) noexcept
+		: file(std::move(other.file))
+		, header(exchange(other.header, nullptr))
+		, slots(exchange(other.slots, nullptr))
+		, pool(exchange(other.pool, nullptr))
+	{;}
+
+
+	ConfigSnapshot& ConfigSnapshot::operator=(ConfigSnapshot&& other) noexcept {
+		if (this != &other) {
+			file = std::move(other.file);
+			header = exchange(other.header, nullptr);
+			slots = exchange(other.slots, nullptr);
+			pool = exchange(other.pool, nullptr);
+		}
+		return *this;
+	}
+
+
+	ConfigSnapshot::~ConfigSnapshot() {;}
+
+
+	bool ConfigSnapshot::open(const char* path, bool verifyChecksum) {
+		using snapshot::Header;
+		using snapshot::Slot;
+
+		header = nullptr;
+		slots = nullptr;
+		pool = nullptr;
+
+		try {
+			file.reset(new MappedFile(path, MappedFile::ACCESS::RANDOM));
+		} catch (const invalid_argument& e) {
+			fprintf(stderr, "%s\n", e.what());
+			file.reset();
+			return false;
+		}
+
+		const char* error = nullptr;
+		const uint64_t size = file->size();
+		const Header* h = reinterpret_cast<const Header*>(file->begin());
+
+		if (size < sizeof(Header) || memcmp(h->magic, snapshot::MAGIC, sizeof(h->magic)) != 0)
+			error = "not a config snapshot";
+		else if (h->version != snapshot::VERSION)
+			error = "unsupported snapshot version";
+		else if (h->byteOrder != snapshot::ENDIAN_TAG)
+			error = "snapshot was written with a different byte order";
+		else if (h->slotCount == 0 || (h->slotCount & (h->slotCount - 1)) != 0 || h->entryCount >= h->slotCount
+		         || h->indexOffset < sizeof(Header) || h->indexOffset % alignof(Slot) != 0
+		         || h->slotCount > (size - h->indexOffset) / sizeof(Slot)
+		         || h->poolOffset < h->indexOffset + h->slotCount * sizeof(Slot)
+		         || h->poolOffset > size || h->poolSize != size - h->poolOffset)
+			error = "corrupt snapshot header";
+		else if (verifyChecksum && hashKey(string_view(file->begin() + h->indexOffset, size - h->indexOffset)) != h->checksum)
+			error = "snapshot checksum mismatch";
+
+		if (error != nullptr) {
+			fprintf(stderr, "%s: %s\n", path, error);
+			file.reset();
+			return false;
+		}
+
+		header = h;
+		slots = reinterpret_cast<const Slot*>(file->begin() + h->indexOffset);
+		pool = file->begin() + h->poolOffset;
+		return true;
+	}
+
+
+	ConfigSnapshot::value_t ConfigSnapshot::find(string_view key, uint64_t hash) const noexcept {
+		if (header == nullptr)
+			return value_t();
+
+		const uint64_t stored = snapshot::slotHash(hash);
+		const uint64_t mask = header->slotCount - 1;
+
+		// a valid file is at most half full, so the probe stops at an empty slot; the step limit only
+		// matters for a damaged index opened without verifying the checksum
+		uint64_t idx = stored & mask;
+		for (uint64_t step = 0; step < header->slotCount && slots[idx].type != snapshot::SLOT_EMPTY; ++step, idx = (idx + 1) & mask) {
+			const snapshot::Slot& s = slots[idx];
+
+			if (s.hash == stored && s.keyLength == key.size() && keyInBounds(s)
+			    && memcmp(pool + s.keyOffset, key.data(), key.size()) == 0)
+				return valueOf(s);
+		}
+
+		return value_t();
+	}
+
+
+	ConfigSnapshot::value_t ConfigSnapshot::valueOf(const snapshot::Slot& slot) const noexcept {
+		switch (slot.type) {
+		case snapshot::SLOT_STRING:
+			if (slot.payload > header->poolSize || slot.valueLength > header->poolSize - slot.payload)
+				return value_t();
+			return value_t::makeStringView(string_view(pool + slot.payload, slot.valueLength));
+
+		case snapshot::SLOT_NUMBER: {
+				double number;
+				memcpy(&number, &slot.payload, sizeof(number));
+				return value_t(number);
+			}
+
+		case snapshot::SLOT_BOOL:
+			return value_t(slot.payload != 0);
+		}
+
+		return value_t();
+	}
+
+} // namespace gg
@@ -0,0 +1,144 @@
+#ifndef GG_CONFIG_SNAPSHOT_HPP
+#define GG_CONFIG_SNAPSHOT_HPP
+
+#include "ggconfig_file.hpp"
+#include "ggconfig_key.hpp"
+#include "ggconfig_value.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+
+namespace gg {
+
+	/*
+	Binary snapshot of a ConfigStorage, written by ConfigStorage::saveSnapshot().
+
+	Layout (host byte order, every section 8 byte aligned):
+		header   -- magic, version, byte order tag, sizes, offsets and a checksum of everything after it;
+		index    -- open-addressing table (linear probing, at most half full) of fixed size slots:
+		            full key hash, key offset & length, value type and payload;
+		pool     -- key bytes and string values, back to back.
+
+	The file is queried right where it's mapped, nothing is deserialized, so any number of processes
+	can share the same page cache copy. The hash is gg::hashKey(): changing it needs a version bump.
+	*/
+	namespace snapshot {
+
+		constexpr char MAGIC[8] = {'G', 'G', 'C', 'S', 'N', 'A', 'P', '\0'};
+		constexpr uint32_t VERSION = 1;
+		constexpr uint32_t ENDIAN_TAG = 0x01020304;
+
+		struct Header {
+			char magic[8];
+			uint32_t version;
+			uint32_t byteOrder;
+			uint64_t entryCount;
+			uint64_t slotCount;     // power of 2
+			uint64_t indexOffset;
+			uint64_t poolOffset;
+			uint64_t poolSize;
+			uint64_t checksum;      // hashKey() of [indexOffset, end of file)
+		};
+
+		/* Value types in a slot; 0 is an empty slot */
+		enum: uint8_t {
+			SLOT_EMPTY,
+			SLOT_STRING,
+			SLOT_NUMBER,
+			SLOT_BOOL
+		};
+
+		struct Slot {
+			uint64_t hash;          // never 0
+			uint64_t keyOffset;     // into the pool
+			uint64_t payload;       // double bits, bool, or string offset into the pool
+			uint32_t keyLength;
+			uint32_t valueLength;   // strings only
+			uint8_t type;
+			uint8_t padding[7];
+		};
+
+		static_assert(sizeof(Header) == 64, "snapshot header layout changed");
+		static_assert(sizeof(Slot) == 40, "snapshot slot layout changed");
+
+		/* Hash as stored in a slot */
+		constexpr uint64_t slotHash(uint64_t hash) noexcept { return hash != 0 ? hash : 1; }
+
+	} // namespace snapshot
+
+
+	/* Read-only view of a snapshot file */
+	class ConfigSnapshot {
+	public:
+		using value_t = ConfigValue;
+
+		ConfigSnapshot() noexcept;
+		/* The moved-from snapshot is left closed */
+		ConfigSnapshot(ConfigSnapshot&& other) noexcept;
+		ConfigSnapshot& operator=(ConfigSnapshot&& other) noexcept;
+		virtual ~ConfigSnapshot();
+
+		/*
+		Map a snapshot file; prints the reason to stderr and returns false if it's not valid.
+		Verifying the checksum reads the whole file; skip it to only touch the pages that are looked up.
+		*/
+		bool open(const char* path, bool verifyChecksum = true);
+
+		bool isOpen() const noexcept { return header != nullptr; }
+		size_t size() const noexcept { return header != nullptr ? header->entryCount : 0; }
+
+		/*
+		Lookups return values by value, a null value if the key doesn't exist.
+		Strings longer than ConfigValue::INLINE_CAPACITY point into the mapping: they're valid while the snapshot is open.
+		*/
+		value_t find(std::string_view key) const noexcept { return find(key, hashKey(key)); }
+		value_t find(const ConfigKey& key) const noexcept { return find(key.name(), key.hash()); }
+		value_t find(std::string_view key, uint64_t hash) const noexcept;
+
+		template <typename Key>
+		value_t operator[](const Key& key) const noexcept { return find(key); }
+
+		/* Typed getters; return def if the key doesn't exist or holds another type. Key: string_view or ConfigKey */
+		template <typename Key>
+		std::string_view getString(const Key& key, std::string_view def = std::string_view()) const noexcept { return find(key).asString(def); }
+
+		template <typename Key>
+		double getDouble(const Key& key, double def = 0.0) const noexcept { return find(key).asNumber(def); }
+
+		template <typename Key>
+		bool getBool(const Key& key, bool def = false) const noexcept { return find(key).asBool(def); }
+
+		/* Call f(std::string_view key, const value_t& value) for every entry, in slot order */
+		template <typename F>
+		void forEach(F f) const {
+			for (uint64_t i = 0; i < slotCount(); ++i) {
+				if (slots[i].type != snapshot::SLOT_EMPTY && keyInBounds(slots[i]))
+					f(keyOf(slots[i]), valueOf(slots[i]));
+			}
+		}
+
+	private:
+		std::unique_ptr<MappedFile> file;
+		const snapshot::Header* header;
+		const snapshot::Slot* slots;
+		const char* pool;
+
+		uint64_t slotCount() const noexcept { return header != nullptr ? header->slotCount : 0; }
+
+		bool keyInBounds(const snapshot::Slot& slot) const noexcept {
+			return slot.keyOffset <= header->poolSize && slot.keyLength <= header->poolSize - slot.keyOffset;
+		}
+
+		std::string_view keyOf(const snapshot::Slot& slot) const noexcept {
+			return std::string_view(pool + slot.keyOffset, slot.keyLength);
+		}
+
+		value_t valueOf(const snapshot::Slot& slot) const noexcept;
+	};
+
+} // namespace gg
+
+#endif // GG_CONFIG_SNAPSHOT_HPP
@@ -0,0 +1,79 @@
+#include "ggconfig_stack.hpp"
+
+#include <utility>
+
+using namespace std;
+
+
+namespace gg {
+
+	ConfigStack::layer_t ConfigStack::loadLayer(const char* path, const ParseOptions& options) {
+		shared_ptr<ConfigStorage> layer = make_shared<ConfigStorage>();
+		if (!layer->parseFile(path, options))
+			return nullptr;
+
+		return layer;
+	}
+
+
+	ConfigStack::ConfigStack()
+		: layers()
+		, cache()
+	{;}
+
+
+	ConfigStack::~ConfigStack() {;}
+
+
+	size_t ConfigStack::push(layer_t layer) {
+		layers.push_back(std::move(layer));
+		cache.clear();
+		return layers.size() - 1;
+	}
+
+
+	bool ConfigStack::pushFile(const char* path, const ParseOptions& options) {
+		layer_t layer = loadLayer(path, options);
+		if (layer == nullptr)
+			return false;
+
+		push(std::move(layer));
+		return true;
+	}
+
+
+	void ConfigStack::replace(size_t index, layer_t layer) {
+		layers.at(index) = std::move(layer);
+		cache.clear();
+	}
+
+
+	bool ConfigStack::reload(size_t index, const char* path, const ParseOptions& options) {
+		layer_t layer = loadLayer(path, options);
+		if (layer == nullptr)
+			return false;
+
+		replace(index, std::move(layer));
+		return true;
+	}
+
+
+	const ConfigStack::value_t* ConfigStack::find(string_view key, uint64_t hash) {
+		const value_t* const* cached = cache.find(key, hash);
+		if (cached != nullptr)
+			return *cached;
+
+		// top-down; the same hash is used for every layer
+		const value_t* found = nullptr;
+		for (auto it = layers.rbegin(); it != layers.rend() && found == nullptr; ++it) {
+			if (*it != nullptr)
+				found = (*it)->storage.find(key, hash);
+		}
+
+		// misses aren't cached: any number of different missing keys could be asked for
+		if (found != nullptr)
+			cache.insert(key, hash).first = found;
+		return found;
+	}
+
+} // namespace gg
@@ -0,0 +1,97 @@
+#ifndef GG_CONFIG_STACK_HPP
+#define GG_CONFIG_STACK_HPP
+
+#include "ggconfig.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+
+namespace gg {
+
+	/*
+	Several config files on top of each other, e.g. base, environment and host overrides.
+	A lookup returns the value of the topmost layer that has the key; nothing is copied or merged.
+
+	Layers are parsed storages that are never modified, so any number of stacks (in any thread) can share them.
+	The stack itself remembers where every key it found resolved to: the cache is only dropped when the layers change,
+	and never holds more keys than the layers do (misses aren't cached). Lookups fill the cache, so they aren't const:
+	a stack is used by one thread at a time; give every thread its own stack over the same layers.
+	*/
+	class ConfigStack {
+	public:
+		using value_t = ConfigStorage::value_t;
+		using layer_t = std::shared_ptr<const ConfigStorage>;
+
+		/* Parse a file into a layer; nullptr if it fails */
+		static layer_t loadLayer(const char* path, const ParseOptions& options = ParseOptions());
+
+		ConfigStack();
+		ConfigStack(ConfigStack&&) = default;
+		ConfigStack& operator=(ConfigStack&&) = default;
+		virtual ~ConfigStack();
+
+		/* Put a layer on top of the others; returns its index (the bottom layer is 0) */
+		size_t push(layer_t layer);
+
+		/* Same, loading the layer from a file; false if it fails */
+		bool pushFile(const char* path, const ParseOptions& options = ParseOptions());
+
+		/* Swap a layer for a new version of it, e.g. after its file changed */
+		void replace(size_t index, layer_t layer);
+
+		/* Reload a layer from a file; the current version is kept if it fails */
+		bool reload(size_t index, const char* path, const ParseOptions& options = ParseOptions());
+
+		/* Layer info */
+		size_t size() const noexcept { return layers.size(); }
+		const layer_t& layer(size_t index) const { return layers.at(index); }
+
+		/* Value of the topmost layer that has the key; nullptr if none of them have it */
+		const value_t* find(std::string_view key) { return find(key, hashKey(key)); }
+		const value_t* find(const ConfigKey& key) { return find(key.name(), key.hash()); }
+		const value_t* find(std::string_view key, uint64_t hash);
+
+		/** Access operator; returns ConfigStorage::null if no layer has the key */
+		template <typename Key>
+		const value_t& operator[](const Key& key) {
+			const value_t* elem = find(key);
+			return elem != nullptr ? *elem : ConfigStorage::null;
+		}
+
+		/* Typed getters; return def if the key doesn't exist or holds another type. Key: string_view or ConfigKey */
+		template <typename Key>
+		std::string_view getString(const Key& key, std::string_view def = std::string_view()) {
+			const value_t* elem = find(key);
+			return elem != nullptr ? elem->asString(def) : def;
+		}
+
+		template <typename Key>
+		double getDouble(const Key& key, double def = 0.0) {
+			const value_t* elem = find(key);
+			return elem != nullptr ? elem->asNumber(def) : def;
+		}
+
+		template <typename Key>
+		bool getBool(const Key& key, bool def = false) {
+			const value_t* elem = find(key);
+			return elem != nullptr ? elem->asBool(def) : def;
+		}
+
+		/* Number of keys whose resolution is cached */
+		size_t cachedKeys() const noexcept { return cache.size(); }
+
+	private:
+		/* Bottom to top */
+		std::vector<layer_t> layers;
+
+		/* Key -> the value it resolved to */
+		FlatTable<const value_t*> cache;
+	};
+
+} // namespace gg
+
+#endif // GG_CONFIG_STACK_HPP
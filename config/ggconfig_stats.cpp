@@ -0,0 +1,309 @@
+#include "ggconfig_stats.hpp"
+#include "ggconfig.hpp"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <new>
+
+using namespace std;
+
+
+namespace {
+
+	/* 0 marks a free slot */
+	uint64_t storedHash(uint64_t hash) noexcept {
+		return hash != 0 ? hash : 1;
+	}
+
+
+	size_t slotCount(size_t maxKeys) noexcept {
+		size_t n = 16;
+		while (n < 2 * maxKeys)
+			n *= 2;
+		return n;
+	}
+
+
+	void appendf(string& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+	void appendf(string& out, const char* format, ...) {
+		char buf[512];
+		va_list args;
+		va_start(args, format);
+		const int n = vsnprintf(buf, sizeof(buf), format, args);
+		va_end(args);
+
+		if (n > 0)
+			out.append(buf, min<size_t>(n, sizeof(buf) - 1));
+	}
+
+
+	void appendJsonString(string& out, string_view str) {
+		out += '"';
+		for (const char c: str) {
+			switch (c) {
+			case '"':  out += "\\\""; break;
+			case '\\': out += "\\\\"; break;
+			case '\n': out += "\\n"; break;
+			case '\t': out += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+					appendf(out, "\\u%04x", static_cast<unsigned>(c));
+				else
+					out += c;
+				break;
+			}
+		}
+		out += '"';
+	}
+
+} // anon namespace
+
+
+namespace gg {
+
+	const char* ConfigStats::phaseName(PHASE phase) noexcept {
+		switch (phase) {
+		case PHASE::READ:  return "read";
+		case PHASE::PARSE: return "parse";
+		case PHASE::MERGE: return "merge";
+		case PHASE::INDEX: return "index";
+		case PHASE::COUNT: break;
+		}
+
+		return "unknown";
+	}
+
+
+	ConfigStats::ConfigStats(size_t maxKeys)
+		: maxKeys(maxKeys)
+		, mask(slotCount(maxKeys) - 1)
+		, slots(new Slot[slotCount(maxKeys)])
+		, tracked(0)
+		, untrackedHits(0)
+		, untrackedMisses(0)
+		, parseCount(0)
+		, parseBytes(0)
+	{
+		reset();
+	}
+
+
+	ConfigStats::~ConfigStats() {;}
+
+
+	void ConfigStats::recordLookup(string_view key, uint64_t hash, bool hit) noexcept {
+		const uint64_t stored = storedHash(hash);
+
+		// linear probing; the table has room for twice as many keys as are tracked, so there's always a free slot
+		for (size_t idx = stored & mask; ; idx = (idx + 1) & mask) {
+			Slot& s = slots[idx];
+			uint64_t h = s.hash.load(memory_order_relaxed);
+
+			if (h == 0) {
+				if (tracked.load(memory_order_relaxed) >= maxKeys)
+					break;
+
+				// claim the slot; if another thread was faster, h tells for which key
+				if (s.hash.compare_exchange_strong(h, stored, memory_order_relaxed)) {
+					tracked.fetch_add(1, memory_order_relaxed);
+					try {
+						s.name.assign(key.data(), key.size());
+						s.named.store(true, memory_order_release);
+					} catch (const bad_alloc&) {;}
+					h = stored;
+				}
+			}
+
+			if (h == stored) {
+				(hit ? s.hits : s.misses).fetch_add(1, memory_order_relaxed);
+				return;
+			}
+		}
+
+		(hit ? untrackedHits : untrackedMisses).fetch_add(1, memory_order_relaxed);
+	}
+
+
+	void ConfigStats::recordParse(uint64_t bytes, const ParseProfile& profile) noexcept {
+		parseCount.fetch_add(1, memory_order_relaxed);
+		parseBytes.fetch_add(bytes, memory_order_relaxed);
+		for (size_t i = 0; i < PARSER_STATE_COUNT; ++i)
+			stateCounts[i].fetch_add(profile.stateBytes[i], memory_order_relaxed);
+	}
+
+
+	void ConfigStats::recordPhase(PHASE phase, uint64_t nanoseconds) noexcept {
+		phaseTimes[static_cast<size_t>(phase)].fetch_add(nanoseconds, memory_order_relaxed);
+	}
+
+
+	vector<ConfigStats::KeyCounts> ConfigStats::lookups() const {
+		vector<KeyCounts> result;
+
+		for (size_t i = 0; i <= mask; ++i) {
+			const Slot& s = slots[i];
+			if (s.named.load(memory_order_acquire))
+				result.push_back(KeyCounts{s.name, s.hits.load(memory_order_relaxed), s.misses.load(memory_order_relaxed)});
+		}
+
+		sort(result.begin(), result.end(), [](const KeyCounts& a, const KeyCounts& b) {
+			const uint64_t x = a.hits + a.misses, y = b.hits + b.misses;
+			return x != y ? x > y : a.key < b.key;
+		});
+
+		return result;
+	}
+
+
+	uint64_t ConfigStats::hits() const noexcept {
+		uint64_t total = untrackedHits.load(memory_order_relaxed);
+		for (size_t i = 0; i <= mask; ++i)
+			total += slots[i].hits.load(memory_order_relaxed);
+		return total;
+	}
+
+
+	uint64_t ConfigStats::misses() const noexcept {
+		uint64_t total = untrackedMisses.load(memory_order_relaxed);
+		for (size_t i = 0; i <= mask; ++i)
+			total += slots[i].misses.load(memory_order_relaxed);
+		return total;
+	}
+
+
+	vector<string> ConfigStats::unusedKeys(const ConfigStorage& cs) const {
+		vector<string> result;
+
+		for (const auto& e: cs.storage) {
+			const uint64_t stored = storedHash(hashKey(e.key()));
+
+			bool used = false;
+			for (size_t idx = stored & mask; ; idx = (idx + 1) & mask) {
+				const uint64_t h = slots[idx].hash.load(memory_order_relaxed);
+				if (h == 0 || h == stored) {
+					used = h == stored && slots[idx].hits.load(memory_order_relaxed) != 0;
+					break;
+				}
+			}
+
+			if (!used)
+				result.emplace_back(e.key());
+		}
+
+		sort(result.begin(), result.end());
+		return result;
+	}
+
+
+	string ConfigStats::textReport(const ConfigStorage* cs) const {
+		string out;
+
+		const vector<KeyCounts> keys = lookups();
+		appendf(out, "Lookups: %llu hits, %llu misses, %zu keys tracked (%llu hits, %llu misses of untracked keys)\n",
+		        static_cast<unsigned long long>(hits()), static_cast<unsigned long long>(misses()), keys.size(),
+		        static_cast<unsigned long long>(untrackedHits.load(memory_order_relaxed)),
+		        static_cast<unsigned long long>(untrackedMisses.load(memory_order_relaxed)));
+
+		if (!keys.empty())
+			appendf(out, "  %12s %12s  %s\n", "hits", "misses", "key");
+		for (const auto& k: keys)
+			appendf(out, "  %12llu %12llu  %.*s\n", static_cast<unsigned long long>(k.hits), static_cast<unsigned long long>(k.misses),
+			        static_cast<int>(min<size_t>(k.key.size(), 256)), k.key.c_str());
+
+		if (cs != nullptr) {
+			const vector<string> unused = unusedKeys(*cs);
+			appendf(out, "Unused keys: %zu of %zu\n", unused.size(), cs->storage.size());
+			for (const auto& key: unused)
+				appendf(out, "  %.*s\n", static_cast<int>(min<size_t>(key.size(), 256)), key.c_str());
+		}
+
+		const uint64_t bytes = parsedBytes();
+		appendf(out, "Parsing: %llu parses, %llu bytes\n", static_cast<unsigned long long>(parses()), static_cast<unsigned long long>(bytes));
+
+		appendf(out, "  %-12s %12s\n", "phase", "ms");
+		for (size_t i = 0; i < static_cast<size_t>(PHASE::COUNT); ++i) {
+			const PHASE phase = static_cast<PHASE>(i);
+			appendf(out, "  %-12s %12.3f\n", phaseName(phase), phaseNanoseconds(phase) / 1e6);
+		}
+
+		appendf(out, "  %-12s %12s %8s\n", "state", "bytes", "share");
+		for (size_t i = 0; i < PARSER_STATE_COUNT; ++i) {
+			const ParserState state = static_cast<ParserState>(i);
+			const uint64_t n = stateBytes(state);
+			appendf(out, "  %-12s %12llu %7.1f%%\n", parserStateName(state), static_cast<unsigned long long>(n), bytes != 0 ? 100.0 * n / bytes : 0.0);
+		}
+
+		return out;
+	}
+
+
+	string ConfigStats::jsonReport(const ConfigStorage* cs) const {
+		string out;
+
+		appendf(out, "{\"lookups\":{\"hits\":%llu,\"misses\":%llu,\"untracked_hits\":%llu,\"untracked_misses\":%llu,\"keys\":[",
+		        static_cast<unsigned long long>(hits()), static_cast<unsigned long long>(misses()),
+		        static_cast<unsigned long long>(untrackedHits.load(memory_order_relaxed)),
+		        static_cast<unsigned long long>(untrackedMisses.load(memory_order_relaxed)));
+
+		const vector<KeyCounts> keys = lookups();
+		for (size_t i = 0; i < keys.size(); ++i) {
+			out += i != 0 ? ",{\"key\":" : "{\"key\":";
+			appendJsonString(out, keys[i].key);
+			appendf(out, ",\"hits\":%llu,\"misses\":%llu}", static_cast<unsigned long long>(keys[i].hits), static_cast<unsigned long long>(keys[i].misses));
+		}
+		out += "]";
+
+		if (cs != nullptr) {
+			out += ",\"unused\":[";
+			const vector<string> unused = unusedKeys(*cs);
+			for (size_t i = 0; i < unused.size(); ++i) {
+				if (i != 0)
+					out += ',';
+				appendJsonString(out, unused[i]);
+			}
+			out += "]";
+		}
+
+		appendf(out, "},\"parse\":{\"parses\":%llu,\"bytes\":%llu,\"phase_ms\":{",
+		        static_cast<unsigned long long>(parses()), static_cast<unsigned long long>(parsedBytes()));
+		for (size_t i = 0; i < static_cast<size_t>(PHASE::COUNT); ++i) {
+			const PHASE phase = static_cast<PHASE>(i);
+			appendf(out, "%s\"%s\":%.3f", i != 0 ? "," : "", phaseName(phase), phaseNanoseconds(phase) / 1e6);
+		}
+
+		out += "},\"state_bytes\":{";
+		for (size_t i = 0; i < PARSER_STATE_COUNT; ++i) {
+			const ParserState state = static_cast<ParserState>(i);
+			appendf(out, "%s\"%s\":%llu", i != 0 ? "," : "", parserStateName(state), static_cast<unsigned long long>(stateBytes(state)));
+		}
+		out += "}}}";
+
+		return out;
+	}
+
+
+	void ConfigStats::reset() noexcept {
+		for (size_t i = 0; i <= mask; ++i) {
+			Slot& s = slots[i];
+			s.hash.store(0, memory_order_relaxed);
+			s.hits.store(0, memory_order_relaxed);
+			s.misses.store(0, memory_order_relaxed);
+			s.named.store(false, memory_order_relaxed);
+			s.name.clear();
+		}
+
+		tracked.store(0, memory_order_relaxed);
+		untrackedHits.store(0, memory_order_relaxed);
+		untrackedMisses.store(0, memory_order_relaxed);
+
+		parseCount.store(0, memory_order_relaxed);
+		parseBytes.store(0, memory_order_relaxed);
+		for (auto& n: stateCounts)
+			n.store(0, memory_order_relaxed);
+		for (auto& t: phaseTimes)
+			t.store(0, memory_order_relaxed);
+	}
+
+} // namespace gg
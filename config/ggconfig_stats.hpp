@@ -0,0 +1,107 @@
+#ifndef GG_CONFIG_STATS_HPP
+#define GG_CONFIG_STATS_HPP
+
+#include "ggconfig_parser.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace gg {
+
+	class ConfigStorage;
+
+
+	/*
+	Instrumentation for ConfigStorage: which keys are looked up and how often they miss,
+	and where parsing spends its time and its input.
+
+	Attach it with ConfigStorage::attachStats(); a storage without one pays a single branch per lookup.
+	Counters are relaxed atomics, so any number of threads may look up keys while it's attached,
+	and one ConfigStats may serve several storages. It must outlive them, or be detached first.
+	*/
+	class ConfigStats {
+	public:
+		/* Phases of parsing */
+		enum class PHASE {
+			READ,    // mapping the file, reading the stream
+			PARSE,   // the state machine, and storing the values
+			MERGE,   // merging chunks parsed in parallel
+			INDEX,   // building the sorted index for views
+			COUNT
+		};
+
+		static const char* phaseName(PHASE phase) noexcept;
+
+		/* Lookups of one key */
+		struct KeyCounts {
+			std::string key;
+			uint64_t hits;
+			uint64_t misses;
+		};
+
+		/* Keys after the first maxKeys are only counted in the totals */
+		explicit ConfigStats(size_t maxKeys = 4096);
+		~ConfigStats();
+
+		ConfigStats(const ConfigStats&) = delete;
+		ConfigStats& operator=(const ConfigStats&) = delete;
+
+		/* Recording; called by ConfigStorage */
+		void recordLookup(std::string_view key, uint64_t hash, bool hit) noexcept;
+		void recordParse(uint64_t bytes, const ParseProfile& profile) noexcept;
+		void recordPhase(PHASE phase, uint64_t nanoseconds) noexcept;
+
+		/* Every tracked key, the most looked up first */
+		std::vector<KeyCounts> lookups() const;
+
+		/* Totals, untracked keys included */
+		uint64_t hits() const noexcept;
+		uint64_t misses() const noexcept;
+
+		/* Keys of a storage that were never found: candidates for pruning (only meaningful while every key is tracked) */
+		std::vector<std::string> unusedKeys(const ConfigStorage& cs) const;
+
+		uint64_t parses() const noexcept { return parseCount.load(std::memory_order_relaxed); }
+		uint64_t parsedBytes() const noexcept { return parseBytes.load(std::memory_order_relaxed); }
+		uint64_t stateBytes(ParserState state) const noexcept { return stateCounts[static_cast<size_t>(state)].load(std::memory_order_relaxed); }
+		uint64_t phaseNanoseconds(PHASE phase) const noexcept { return phaseTimes[static_cast<size_t>(phase)].load(std::memory_order_relaxed); }
+
+		/* Reports; the unused keys are listed if a storage is given */
+		std::string textReport(const ConfigStorage* cs = nullptr) const;
+		std::string jsonReport(const ConfigStorage* cs = nullptr) const;
+
+		/* Zero every counter and forget the tracked keys; no lookups may be recorded meanwhile */
+		void reset() noexcept;
+
+	private:
+		/* One tracked key, on a cache line of its own so threads counting different keys don't share lines */
+		struct alignas(64) Slot {
+			std::atomic<uint64_t> hash;       // 0 if free
+			std::atomic<uint64_t> hits;
+			std::atomic<uint64_t> misses;
+			std::atomic<bool> named;          // name is written, after the slot is claimed
+			std::string name;
+		};
+
+		const size_t maxKeys;
+		const size_t mask;
+		std::unique_ptr<Slot[]> slots;
+		std::atomic<size_t> tracked;
+		std::atomic<uint64_t> untrackedHits;
+		std::atomic<uint64_t> untrackedMisses;
+
+		std::atomic<uint64_t> parseCount;
+		std::atomic<uint64_t> parseBytes;
+		std::atomic<uint64_t> stateCounts[PARSER_STATE_COUNT];
+		std::atomic<uint64_t> phaseTimes[static_cast<size_t>(PHASE::COUNT)];
+	};
+
+} // namespace gg
+
+#endif // GG_CONFIG_STATS_HPP
@@ -0,0 +1,312 @@
+#ifndef GG_CONFIG_TABLE_HPP
+#define GG_CONFIG_TABLE_HPP
+
+#include "ggconfig_value.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace gg {
+
+	/* 64 bit hash of a key; reads 8 bytes per step (the compiler turns the shifts into one load) */
+	constexpr uint64_t hashKey(std::string_view key) noexcept {
+		constexpr uint64_t K0 = 0x9E3779B97F4A7C15ull;
+		constexpr uint64_t K1 = 0xBF58476D1CE4E5B9ull;
+		constexpr uint64_t K2 = 0x94D049BB133111EBull;
+
+		const size_t size = key.size();
+		uint64_t h = K0 ^ (size * K1);
+		size_t i = 0;
+
+		const auto byte = [&key](size_t at) constexpr { return static_cast<uint64_t>(static_cast<unsigned char>(key[at])); };
+
+		for (; i + 8 <= size; i += 8) {
+			const uint64_t w =
+				byte(i)          | byte(i + 1) << 8  | byte(i + 2) << 16 | byte(i + 3) << 24 |
+				byte(i + 4) << 32 | byte(i + 5) << 40 | byte(i + 6) << 48 | byte(i + 7) << 56;
+			h = (h ^ (w * K1)) * K2;
+			h ^= h >> 29;
+		}
+
+		uint64_t tail = 0;
+		for (size_t shift = 0; i < size; ++i, shift += 8)
+			tail |= byte(i) << shift;
+		h = (h ^ (tail * K1)) * K2;
+
+		// final avalanche (splitmix64)
+		h ^= h >> 30;
+		h *= K1;
+		h ^= h >> 27;
+		h *= K2;
+		h ^= h >> 31;
+		return h;
+	}
+
+
+	/*
+	Open-addressing hash table from string keys to Mapped, with Robin Hood probing.
+
+	Every slot stores 32 bits of the key's hash next to the key pointer and the value,
+	so a lookup usually touches a single cache line and only compares key bytes on a hash match.
+	Key bytes are copied into one arena and stay put, slots are moved around on insertion and rehash:
+	pointers to values are invalidated by insert(), erase() and reserve().
+	*/
+	template <typename Mapped>
+	class FlatTable {
+	public:
+		/* One slot */
+		struct Entry {
+			uint32_t hash;          // 0 if the slot is empty
+			uint32_t keyLength;
+			const char* keyData;
+			Mapped value;
+
+			std::string_view key() const noexcept { return std::string_view(keyData, keyLength); }
+		};
+
+
+		/* Iterates over the occupied slots, in no particular order */
+		template <typename EntryT>
+		class Iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Entry;
+			using difference_type = std::ptrdiff_t;
+			using pointer = EntryT*;
+			using reference = EntryT&;
+
+			Iterator(EntryT* pos, EntryT* last) noexcept : pos(pos), last(last) { skipEmpty(); }
+
+			reference operator*() const noexcept { return *pos; }
+			pointer operator->() const noexcept { return pos; }
+
+			Iterator& operator++() noexcept { ++pos; skipEmpty(); return *this; }
+			Iterator operator++(int) noexcept { Iterator old = *this; ++*this; return old; }
+
+			bool operator==(const Iterator& other) const noexcept { return pos == other.pos; }
+			bool operator!=(const Iterator& other) const noexcept { return pos != other.pos; }
+
+		private:
+			EntryT* pos;
+			EntryT* last;
+
+			void skipEmpty() noexcept {
+				while (pos != last && pos->hash == 0)
+					++pos;
+			}
+		};
+
+		using iterator = Iterator<Entry>;
+		using const_iterator = Iterator<const Entry>;
+
+
+		FlatTable() noexcept
+			: slots()
+			, mask(0)
+			, count(0)
+			, keys()
+		{;}
+
+		FlatTable(const FlatTable&) = delete;
+		FlatTable& operator=(const FlatTable&) = delete;
+		/* The moved-from table is left empty */
+		FlatTable(FlatTable&& other) noexcept
+			: slots(std::move(other.slots))
+			, mask(std::exchange(other.mask, 0))
+			, count(std::exchange(other.count, 0))
+			, keys(std::move(other.keys))
+		{;}
+
+		FlatTable& operator=(FlatTable&& other) noexcept {
+			slots = std::move(other.slots);
+			mask = std::exchange(other.mask, 0);
+			count = std::exchange(other.count, 0);
+			keys = std::move(other.keys);
+			other.slots.clear();
+			return *this;
+		}
+
+		/* Size info */
+		size_t size() const noexcept { return count; }
+		bool empty() const noexcept { return count == 0; }
+		size_t capacity() const noexcept { return slots.size(); }
+
+		/* Heap bytes used by the slots and the key bytes */
+		size_t memoryUsage() const noexcept { return slots.capacity() * sizeof(Entry) + keys.bytesReserved(); }
+
+		/* Iteration */
+		iterator begin() noexcept { return iterator(slots.data(), slots.data() + slots.size()); }
+		iterator end() noexcept { return iterator(slots.data() + slots.size(), slots.data() + slots.size()); }
+		const_iterator begin() const noexcept { return const_iterator(slots.data(), slots.data() + slots.size()); }
+		const_iterator end() const noexcept { return const_iterator(slots.data() + slots.size(), slots.data() + slots.size()); }
+
+		/* Make room for n keys without rehashing */
+		void reserve(size_t n) {
+			size_t cap = MIN_CAPACITY;
+			while (cap * MAX_LOAD_NUM < n * MAX_LOAD_DEN)
+				cap *= 2;
+
+			if (cap > slots.size())
+				rehash(cap);
+		}
+
+		/* Remove every entry; keeps the capacity, drops the key bytes */
+		void clear() noexcept {
+			for (auto& e: slots)
+				e = Entry();
+			count = 0;
+			keys = StringArena();
+		}
+
+		/* Lookup; nullptr if the key is missing */
+		Mapped* find(std::string_view key) noexcept { return find(key, hashKey(key)); }
+		const Mapped* find(std::string_view key) const noexcept { return find(key, hashKey(key)); }
+
+		Mapped* find(std::string_view key, uint64_t fullHash) noexcept {
+			return const_cast<Mapped*>(static_cast<const FlatTable*>(this)->find(key, fullHash));
+		}
+
+		const Mapped* find(std::string_view key, uint64_t fullHash) const noexcept {
+			const size_t idx = findSlot(key, storedHash(fullHash));
+			return idx != NPOS ? &slots[idx].value : nullptr;
+		}
+
+		/* Insert a default constructed value if the key is missing; returns the value */
+		Mapped& operator[](std::string_view key) { return insert(key, hashKey(key)).first; }
+
+		/* Same as operator[], also tells if the key was inserted */
+		std::pair<Mapped&, bool> insert(std::string_view key, uint64_t fullHash) {
+			const uint32_t hash = storedHash(fullHash);
+
+			if (!slots.empty()) {
+				const size_t idx = findSlot(key, hash);
+				if (idx != NPOS)
+					return std::pair<Mapped&, bool>(slots[idx].value, false);
+			}
+
+			if ((count + 1) * MAX_LOAD_DEN > slots.size() * MAX_LOAD_NUM)
+				rehash(slots.empty() ? MIN_CAPACITY : slots.size() * 2);
+
+			Entry e;
+			e.hash = hash;
+			e.keyLength = static_cast<uint32_t>(key.size());
+			e.keyData = keys.store(key);
+			e.value = Mapped();
+
+			++count;
+			return std::pair<Mapped&, bool>(slots[place(std::move(e))].value, true);
+		}
+
+		/* Remove a key; returns false if it wasn't there */
+		bool erase(std::string_view key) {
+			if (slots.empty())
+				return false;
+
+			size_t idx = findSlot(key, storedHash(hashKey(key)));
+			if (idx == NPOS)
+				return false;
+
+			// backward shift: pull the following displaced entries one slot closer to home
+			size_t next = (idx + 1) & mask;
+			while (slots[next].hash != 0 && distance(next) != 0) {
+				slots[idx] = std::move(slots[next]);
+				idx = next;
+				next = (next + 1) & mask;
+			}
+
+			slots[idx] = Entry();
+			--count;
+			return true;
+		}
+
+		/* Hint the CPU to start loading the home slot of a hash */
+		void prefetch(uint64_t fullHash) const noexcept {
+			if (!slots.empty())
+				__builtin_prefetch(&slots[storedHash(fullHash) & mask]);
+		}
+
+	private:
+		static constexpr size_t NPOS = static_cast<size_t>(-1);
+		static constexpr size_t MIN_CAPACITY = 16;
+
+		/* Grow when more than 7/8 of the slots are taken */
+		static constexpr size_t MAX_LOAD_NUM = 7;
+		static constexpr size_t MAX_LOAD_DEN = 8;
+
+		std::vector<Entry> slots;
+		size_t mask;
+		size_t count;
+		StringArena keys;
+
+		/* Top bit set, so 0 can mean "empty" */
+		static uint32_t storedHash(uint64_t fullHash) noexcept {
+			return static_cast<uint32_t>(fullHash) | 0x80000000u;
+		}
+
+		/* How far a slot's entry is from its home slot */
+		size_t distance(size_t idx) const noexcept {
+			return (idx - slots[idx].hash) & mask;
+		}
+
+		size_t findSlot(std::string_view key, uint32_t hash) const noexcept {
+			if (slots.empty())
+				return NPOS;
+
+			size_t idx = hash & mask;
+			for (size_t dist = 0; ; ++dist, idx = (idx + 1) & mask) {
+				const Entry& e = slots[idx];
+
+				// an entry closer to home than we are means the key would have been placed here
+				if (e.hash == 0 || distance(idx) < dist)
+					return NPOS;
+
+				if (e.hash == hash && e.keyLength == key.size() && std::memcmp(e.keyData, key.data(), key.size()) == 0)
+					return idx;
+			}
+		}
+
+		/* Robin Hood insertion of a key that isn't in the table; returns its slot */
+		size_t place(Entry&& e) {
+			size_t idx = e.hash & mask;
+			size_t result = NPOS;
+
+			for (size_t dist = 0; ; ++dist, idx = (idx + 1) & mask) {
+				Entry& slot = slots[idx];
+
+				if (slot.hash == 0) {
+					slot = std::move(e);
+					return result != NPOS ? result : idx;
+				}
+
+				// take from the rich: the resident moves on if it's closer to its home than we are
+				const size_t slotDist = distance(idx);
+				if (slotDist < dist) {
+					std::swap(slot, e);
+					if (result == NPOS)
+						result = idx;
+					dist = slotDist;
+				}
+			}
+		}
+
+		void rehash(size_t newCapacity) {
+			std::vector<Entry> old(newCapacity);
+			old.swap(slots);
+			mask = newCapacity - 1;
+
+			for (auto& e: old) {
+				if (e.hash != 0)
+					place(std::move(e));
+			}
+		}
+	};
+
+} // namespace gg
+
+#endif // GG_CONFIG_TABLE_HPP
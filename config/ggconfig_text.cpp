@@ -0,0 +1,150 @@
+#include "ggconfig.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+
+namespace {
+
+	/* to_chars() needs at most 24 chars for the shortest round trip form of a double */
+	constexpr size_t MAX_NUMBER_LENGTH = 32;
+
+	/* Chars that have to be escaped in a string: the ones the parser would read differently */
+	struct EscapeTable {
+		char escaped[256];
+
+		constexpr EscapeTable()
+			: escaped()
+		{
+			escaped[static_cast<unsigned char>('\\')] = '\\';
+			escaped[static_cast<unsigned char>('"')] = '"';
+			escaped[static_cast<unsigned char>('\n')] = 'n';
+			escaped[static_cast<unsigned char>('\t')] = 't';
+		}
+	};
+
+	constexpr EscapeTable escapeTable;
+
+
+	char* writeString(char* out, string_view str) {
+		*out++ = '"';
+
+		for (const char c: str) {
+			const char escaped = escapeTable.escaped[static_cast<unsigned char>(c)];
+			if (escaped != '\0') {
+				*out++ = '\\';
+				*out++ = escaped;
+			} else {
+				*out++ = c;
+			}
+		}
+
+		*out++ = '"';
+		return out;
+	}
+
+
+	char* writeNumber(char* out, double number) {
+		// the parser only takes inf and nan after a sign
+		if (isnan(number)) {
+			memcpy(out, "+nan", 4);
+			return out + 4;
+		}
+		if (isinf(number)) {
+			memcpy(out, number < 0 ? "-inf" : "+inf", 4);
+			return out + 4;
+		}
+
+		return to_chars(out, out + MAX_NUMBER_LENGTH, number).ptr;
+	}
+
+} // anon namespace
+
+
+namespace gg {
+
+	void ConfigStorage::writeText(string& out) const {
+		const ConfigView sorted = view();
+		if (sorted.empty())
+			return;
+
+		// the buffer is sized for the worst case (every char of every string escaped) and written through a pointer;
+		// the bound doesn't depend on the order, so it's summed in table order, which is kinder to the cache
+		size_t bound = 0;
+		for (const auto& e: storage) {
+			bound += e.key().size() + 4;
+			switch (e.value.type()) {
+			case value_t::TYPE::STRING: bound += 2 + 2 * e.value.asString().size(); break;
+			case value_t::TYPE::NUMBER: bound += MAX_NUMBER_LENGTH; break;
+			case value_t::TYPE::BOOL:   bound += 5; break;
+			case value_t::TYPE::NONE:   break;
+			}
+		}
+
+		const size_t start = out.size();
+		out.resize(start + bound);
+		char* const begin = &out[0];
+		char* p = begin + start;
+
+		// in sorted order the entries are all over the table: fetch them a few iterations ahead
+		constexpr size_t PREFETCH_DISTANCE = 8;
+		const IndexedEntry* const first = index->entries.data();
+		const size_t count = index->entries.size();
+
+		for (size_t i = 0; i < count; ++i) {
+			if (i + PREFETCH_DISTANCE < count) {
+				__builtin_prefetch(first[i + PREFETCH_DISTANCE].value);
+				__builtin_prefetch(first[i + PREFETCH_DISTANCE].key.data());
+			}
+
+			const string_view key = first[i].key;
+			const value_t& value = *first[i].value;
+			if (value.type() == value_t::TYPE::NONE)
+				continue;
+
+			memcpy(p, key.data(), key.size());
+			p += key.size();
+			memcpy(p, " = ", 3);
+			p += 3;
+
+			switch (value.type()) {
+			case value_t::TYPE::STRING:
+				p = writeString(p, value.asString());
+				break;
+			case value_t::TYPE::NUMBER:
+				p = writeNumber(p, value.asNumber());
+				break;
+			case value_t::TYPE::BOOL: {
+					const string_view literal = value.asBool() ? "true" : "false";
+					memcpy(p, literal.data(), literal.size());
+					p += literal.size();
+				} break;
+			case value_t::TYPE::NONE:
+				break;
+			}
+
+			*p++ = '\n';
+		}
+
+		out.resize(p - begin);
+	}
+
+
+	string ConfigStorage::toText() const {
+		string out;
+		writeText(out);
+		return out;
+	}
+
+
+	bool ConfigStorage::saveText(const char* path) const {
+		string out;
+		writeText(out);
+		return writeFileAtomically(path, out);
+	}
+
+} // namespace gg
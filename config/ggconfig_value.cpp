@@ -0,0 +1,164 @@
+#include "ggconfig_value.hpp"
+#include "ggconfig_parser.hpp"
+
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+
+namespace gg {
+
+	StringArena::StringArena() noexcept
+		: blocks()
+		, head(nullptr)
+		, left(0)
+		, used(0)
+		, reserved(0)
+	{;}
+
+
+	StringArena::StringArena(StringArena&& other) noexcept
+		: blocks(std::move(other.blocks))
+		, head(exchange(other.head, nullptr))
+		, left(exchange(other.left, 0))
+		, used(exchange(other.used, 0))
+		, reserved(exchange(other.reserved, 0))
+	{
+		other.blocks.clear();
+	}
+
+
+	StringArena& StringArena::operator=(StringArena&& other) noexcept {
+		blocks = std::move(other.blocks);
+		head = exchange(other.head, nullptr);
+		left = exchange(other.left, 0);
+		used = exchange(other.used, 0);
+		reserved = exchange(other.reserved, 0);
+		other.blocks.clear();
+		return *this;
+	}
+
+
+	const char* StringArena::store(string_view str) {
+		const size_t size = str.size();
+
+		if (size > left) {
+			// big strings get a block of their own, so the current block isn't wasted
+			if (size > BLOCK_SIZE / 4) {
+				blocks.emplace_back(new char[size]);
+				reserved += size;
+				used += size;
+				memcpy(blocks.back().get(), str.data(), size);
+				return blocks.back().get();
+			}
+
+			blocks.emplace_back(new char[BLOCK_SIZE]);
+			reserved += BLOCK_SIZE;
+			head = blocks.back().get();
+			left = BLOCK_SIZE;
+		}
+
+		char* dest = head;
+		memcpy(dest, str.data(), size);
+		head += size;
+		left -= size;
+		used += size;
+		return dest;
+	}
+
+
+	LazyString::LazyString(string_view raw) noexcept
+		: raw(raw)
+		, decoded(nullptr)
+	{;}
+
+
+	LazyString::~LazyString() {
+		delete decoded.load(memory_order_relaxed);
+	}
+
+
+	string_view LazyString::get() const {
+		const string* str = decoded.load(memory_order_acquire);
+		if (str != nullptr)
+			return *str;
+
+		unique_ptr<string> fresh(new string());
+		unescape(raw, *fresh);
+
+		if (decoded.compare_exchange_strong(str, fresh.get(), memory_order_acq_rel, memory_order_acquire))
+			return *fresh.release();
+
+		// someone else was faster
+		return *str;
+	}
+
+
+	ConfigValue ConfigValue::makeString(string_view str, StringArena& arena) {
+		if (str.size() <= INLINE_CAPACITY)
+			return makeStringView(str);
+
+		return makeStringView(string_view(arena.store(str), str.size()));
+	}
+
+
+	ConfigValue ConfigValue::makeStringView(string_view str) {
+		ConfigValue v;
+
+		if (str.size() <= INLINE_CAPACITY) {
+			memcpy(v.raw, str.data(), str.size());
+			v.meta = static_cast<unsigned char>(TAG_INLINE | (str.size() << 4));
+			return v;
+		}
+
+		if (str.size() > numeric_limits<uint32_t>::max())
+			throw length_error("gg::ConfigValue strings are limited to 4 GiB");
+
+		const char* ptr = str.data();
+		const uint32_t len = static_cast<uint32_t>(str.size());
+		memcpy(v.raw, &ptr, sizeof(ptr));
+		memcpy(v.raw + sizeof(ptr), &len, sizeof(len));
+		v.meta = TAG_EXTERNAL;
+		return v;
+	}
+
+
+	ConfigValue ConfigValue::makeLazyString(const LazyString& str) noexcept {
+		ConfigValue v;
+		const LazyString* ptr = &str;
+		memcpy(v.raw, &ptr, sizeof(ptr));
+		v.meta = TAG_LAZY;
+		return v;
+	}
+
+
+	bool operator==(const ConfigValue& a, const ConfigValue& b) noexcept {
+		if (a.type() != b.type())
+			return false;
+
+		switch (a.type()) {
+		case ConfigValue::TYPE::NONE:   return true;
+		case ConfigValue::TYPE::STRING: return a.asString() == b.asString();
+		case ConfigValue::TYPE::NUMBER: return a.asNumber() == b.asNumber();
+		case ConfigValue::TYPE::BOOL:   return a.asBool() == b.asBool();
+		}
+
+		return false;
+	}
+
+
+	ostream& operator<<(ostream& out, const ConfigValue& value) {
+		switch (value.type()) {
+		case ConfigValue::TYPE::NONE:   return out << "null";
+		case ConfigValue::TYPE::STRING: return out << value.asString();
+		case ConfigValue::TYPE::NUMBER: return out << value.asNumber();
+		case ConfigValue::TYPE::BOOL:   return out << (value.asBool() ? "true" : "false");
+		}
+
+		return out;
+	}
+
+} // namespace gg
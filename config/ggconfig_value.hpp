@@ -0,0 +1,208 @@
+#ifndef GG_CONFIG_VALUE_HPP
+#define GG_CONFIG_VALUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace gg {
+
+	/*
+	Bump allocator for string bytes.
+	Returned pointers stay valid until the arena is destroyed, moving the arena doesn't invalidate them.
+	Nothing is freed individually.
+	*/
+	class StringArena {
+	public:
+		StringArena() noexcept;
+
+		StringArena(const StringArena&) = delete;
+		StringArena& operator=(const StringArena&) = delete;
+		/* The moved-from arena is left empty; it must not keep filling the moved blocks */
+		StringArena(StringArena&& other) noexcept;
+		StringArena& operator=(StringArena&& other) noexcept;
+
+		/* Copy the bytes into the arena */
+		const char* store(std::string_view str);
+
+		/* Total bytes handed out (not counting block slack) */
+		size_t bytesUsed() const noexcept { return used; }
+
+		/* Total bytes reserved from the heap */
+		size_t bytesReserved() const noexcept { return reserved; }
+
+	private:
+		static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+		std::vector<std::unique_ptr<char[]>> blocks;
+		char* head;
+		size_t left;
+		size_t used;
+		size_t reserved;
+	};
+
+
+	/*
+	A string whose escape sequences are resolved on first access, the result is cached.
+	The raw bytes must outlive it. Any number of threads may call get(): if they race on the first call,
+	every one of them decodes and all but one throw their copy away.
+	*/
+	class LazyString {
+	public:
+		explicit LazyString(std::string_view raw) noexcept;
+		~LazyString();
+
+		LazyString(const LazyString&) = delete;
+		LazyString& operator=(const LazyString&) = delete;
+
+		/* The decoded string */
+		std::string_view get() const;
+
+		bool isDecoded() const noexcept { return decoded.load(std::memory_order_acquire) != nullptr; }
+
+	private:
+		std::string_view raw;
+		mutable std::atomic<const std::string*> decoded;
+	};
+
+
+	/*
+	A 16 byte tagged value: string, number (double) or boolean; or nothing at all (null).
+
+	Strings up to 15 bytes are stored inline. Longer strings only hold a pointer and a length,
+	the bytes are owned by someone else (normally the StringArena of a ConfigStorage).
+	Lazy strings point to a LazyString, which is decoded the first time the value is read.
+
+	The typed accessors never throw: when the value holds another type, the given default is returned.
+	*/
+	class ConfigValue {
+	public:
+		enum class TYPE: unsigned char {
+			NONE,     // null
+			STRING,
+			NUMBER,
+			BOOL
+		};
+
+		/* Longest string stored inline */
+		static constexpr size_t INLINE_CAPACITY = 15;
+
+		/* C-tors */
+		ConfigValue() noexcept
+			: raw()
+			, meta(TAG_NONE)
+		{;}
+
+		explicit ConfigValue(double number) noexcept
+			: raw()
+			, meta(TAG_NUMBER)
+		{
+			std::memcpy(raw, &number, sizeof(number));
+		}
+
+		explicit ConfigValue(bool boolean) noexcept
+			: raw()
+			, meta(TAG_BOOL)
+		{
+			raw[0] = boolean;
+		}
+
+		/* Pointers would silently convert to bool */
+		ConfigValue(const char*) = delete;
+
+		/* String value; copies str into the arena if it doesn't fit inline */
+		static ConfigValue makeString(std::string_view str, StringArena& arena);
+
+		/* String value that doesn't own its bytes if they don't fit inline; str must outlive the value */
+		static ConfigValue makeStringView(std::string_view str);
+
+		/* String value that is decoded on first access; str must outlive the value */
+		static ConfigValue makeLazyString(const LazyString& str) noexcept;
+
+		/* Type checks */
+		TYPE type() const noexcept {
+			switch (tag()) {
+			case TAG_NONE:     return TYPE::NONE;
+			case TAG_NUMBER:   return TYPE::NUMBER;
+			case TAG_BOOL:     return TYPE::BOOL;
+			default:           return TYPE::STRING;
+			}
+		}
+
+		bool isNull()   const noexcept { return tag() == TAG_NONE; }
+		bool isString() const noexcept { return tag() == TAG_INLINE || tag() == TAG_EXTERNAL || tag() == TAG_LAZY; }
+		bool isNumber() const noexcept { return tag() == TAG_NUMBER; }
+		bool isBool()   const noexcept { return tag() == TAG_BOOL; }
+
+		/* Typed accessors; decoding a lazy string may allocate, running out of memory there terminates */
+		std::string_view asString(std::string_view def = std::string_view()) const noexcept {
+			if (tag() == TAG_INLINE)
+				return std::string_view(raw, meta >> 4);
+
+			if (tag() == TAG_EXTERNAL) {
+				const char* ptr;
+				uint32_t len;
+				std::memcpy(&ptr, raw, sizeof(ptr));
+				std::memcpy(&len, raw + sizeof(ptr), sizeof(len));
+				return std::string_view(ptr, len);
+			}
+
+			if (tag() == TAG_LAZY) {
+				const LazyString* lazy;
+				std::memcpy(&lazy, raw, sizeof(lazy));
+				return lazy->get();
+			}
+
+			return def;
+		}
+
+		double asNumber(double def = 0.0) const noexcept {
+			if (tag() != TAG_NUMBER)
+				return def;
+
+			double number;
+			std::memcpy(&number, raw, sizeof(number));
+			return number;
+		}
+
+		bool asBool(bool def = false) const noexcept {
+			return tag() == TAG_BOOL ? raw[0] != 0 : def;
+		}
+
+		/* Values are equal if they have the same type and contents */
+		friend bool operator==(const ConfigValue& a, const ConfigValue& b) noexcept;
+		friend bool operator!=(const ConfigValue& a, const ConfigValue& b) noexcept { return !(a == b); }
+
+	private:
+		/* Low nibble of meta; the high nibble is the inline string length */
+		enum: unsigned char {
+			TAG_NONE,
+			TAG_INLINE,
+			TAG_EXTERNAL,
+			TAG_NUMBER,
+			TAG_BOOL,
+			TAG_LAZY
+		};
+
+		alignas(8) char raw[15];
+		unsigned char meta;
+
+		unsigned char tag() const noexcept { return meta & 0x0F; }
+	};
+
+	static_assert(sizeof(ConfigValue) == 16, "gg::ConfigValue should stay 16 bytes");
+
+
+	/* Outputs strings as-is, numbers and booleans the usual way, null as "null" */
+	std::ostream& operator<<(std::ostream& out, const ConfigValue& value);
+
+} // namespace gg
+
+#endif // GG_CONFIG_VALUE_HPP
@@ -0,0 +1,64 @@
+#include "ggconfig_view.hpp"
+#include "ggconfig.hpp"
+
+#include <algorithm>
+#include <string>
+
+using namespace std;
+
+
+namespace gg {
+
+	ConfigView::ConfigView() noexcept
+		: first(nullptr)
+		, last(nullptr)
+		, prefixLength(0)
+	{;}
+
+
+	ConfigView::ConfigView(const IndexedEntry* first, const IndexedEntry* last, size_t prefixLength) noexcept
+		: first(first)
+		, last(last)
+		, prefixLength(prefixLength)
+	{;}
+
+
+	const ConfigValue* ConfigView::find(string_view key) const noexcept {
+		// every key shares the prefix, so comparing the rest keeps the order
+		const IndexedEntry* it = lower_bound(first, last, key, [this](const IndexedEntry& e, string_view k) {
+			return e.key.substr(prefixLength) < k;
+		});
+
+		return it != last && it->key.substr(prefixLength) == key ? it->value : nullptr;
+	}
+
+
+	const ConfigValue& ConfigView::operator[](string_view key) const noexcept {
+		const ConfigValue* elem = find(key);
+		return elem != nullptr ? *elem : ConfigStorage::null;
+	}
+
+
+	ConfigView ConfigView::withPrefix(string_view prefix) const noexcept {
+		const auto rest = [this](const IndexedEntry& e) { return e.key.substr(prefixLength); };
+
+		// keys starting with prefix sort right after the ones smaller than it, and next to each other
+		const IndexedEntry* from = lower_bound(first, last, prefix, [&rest](const IndexedEntry& e, string_view p) {
+			return rest(e) < p;
+		});
+		const IndexedEntry* to = partition_point(from, last, [&rest, prefix](const IndexedEntry& e) {
+			return rest(e).substr(0, prefix.size()) == prefix;
+		});
+
+		return ConfigView(from, to, prefixLength + prefix.size());
+	}
+
+
+	ConfigView ConfigView::subtree(string_view path) const {
+		string prefix;
+		prefix.reserve(path.size() + 1);
+		prefix.append(path).append(1, '.');
+		return withPrefix(prefix);
+	}
+
+} // namespace gg
@@ -0,0 +1,102 @@
+#ifndef GG_CONFIG_VIEW_HPP
+#define GG_CONFIG_VIEW_HPP
+
+#include "ggconfig_value.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+
+namespace gg {
+
+	/* One key of a sorted index, with its value */
+	struct IndexedEntry {
+		std::string_view key;
+		const ConfigValue* value;
+	};
+
+
+	/*
+	The keys that start with a common prefix, in sorted order: just a range of a storage's prefix index,
+	so it's cheap to make and to copy. Keys are relative to the prefix.
+	Valid until the storage is modified or destroyed.
+	*/
+	class ConfigView {
+	public:
+		/* One key, relative to the prefix */
+		struct Entry {
+			std::string_view key;
+			const ConfigValue& value;
+		};
+
+		class Iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Entry;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = Entry;
+
+			Iterator(const IndexedEntry* pos, size_t prefixLength) noexcept : pos(pos), prefixLength(prefixLength) {;}
+
+			Entry operator*() const noexcept { return Entry{pos->key.substr(prefixLength), *pos->value}; }
+
+			Iterator& operator++() noexcept { ++pos; return *this; }
+			Iterator operator++(int) noexcept { Iterator old = *this; ++pos; return old; }
+
+			bool operator==(const Iterator& other) const noexcept { return pos == other.pos; }
+			bool operator!=(const Iterator& other) const noexcept { return pos != other.pos; }
+
+		private:
+			const IndexedEntry* pos;
+			size_t prefixLength;
+		};
+
+		/* Empty view */
+		ConfigView() noexcept;
+
+		/* The entries in [first, last) must be sorted and share a prefix of prefixLength bytes */
+		ConfigView(const IndexedEntry* first, const IndexedEntry* last, size_t prefixLength) noexcept;
+
+		size_t size() const noexcept { return static_cast<size_t>(last - first); }
+		bool empty() const noexcept { return first == last; }
+
+		Iterator begin() const noexcept { return Iterator(first, prefixLength); }
+		Iterator end() const noexcept { return Iterator(last, prefixLength); }
+
+		/* Lookup by relative key, a binary search; nullptr if the key isn't in the view */
+		const ConfigValue* find(std::string_view key) const noexcept;
+
+		/* Access operator; returns ConfigStorage::null if the key isn't in the view */
+		const ConfigValue& operator[](std::string_view key) const noexcept;
+
+		/* Typed getters; return def if the key doesn't exist or holds another type */
+		std::string_view getString(std::string_view key, std::string_view def = std::string_view()) const noexcept {
+			const ConfigValue* elem = find(key);
+			return elem != nullptr ? elem->asString(def) : def;
+		}
+
+		double getDouble(std::string_view key, double def = 0.0) const noexcept {
+			const ConfigValue* elem = find(key);
+			return elem != nullptr ? elem->asNumber(def) : def;
+		}
+
+		bool getBool(std::string_view key, bool def = false) const noexcept {
+			const ConfigValue* elem = find(key);
+			return elem != nullptr ? elem->asBool(def) : def;
+		}
+
+		/* Narrower views: the keys that start with prefix / the keys under a dotted path ("db" has "db.pool") */
+		ConfigView withPrefix(std::string_view prefix) const noexcept;
+		ConfigView subtree(std::string_view path) const;
+
+	private:
+		const IndexedEntry* first;
+		const IndexedEntry* last;
+		size_t prefixLength;
+	};
+
+} // namespace gg
+
+#endif // GG_CONFIG_VIEW_HPP
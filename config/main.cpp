@@ -1,5 +1,11 @@
 #include "ggconfig.hpp"
+
+#ifdef GGCONFIG_TESTING
+#include "test/test.hpp"
+#endif // GGCONFIG_TESTING
+
 #include <iostream>
+#include <string>
 
 using namespace std;
 
@@ -17,23 +23,25 @@ void run() {
 
 	if (p.parseFile(filename)) {
 		puts("--- Output: ---");
-		for (const auto& pair: p.storage) {
-			cout << "\033[0;36m" << pair.first << "\033[0m = ";
-			switch (pair.second.which()) {
-			case 0: // string
-				cout << pair.second << '\n';
+		for (const auto& entry: p.storage) {
+			cout << "\033[0;36m" << entry.key() << "\033[0m = ";
+			switch (entry.value.type()) {
+			case gg::ConfigValue::TYPE::STRING:
+				cout << entry.value << '\n';
+				break;
+			case gg::ConfigValue::TYPE::NUMBER:
+				cout << "\033[1;36m" << entry.value << "\033[0m\n";
 				break;
-			case 1: // double
-				cout << "\033[1;36m" << pair.second << "\033[0m\n";
+			case gg::ConfigValue::TYPE::BOOL:
+				cout << "\033[1;35m" << entry.value << "\033[0m\n";
 				break;
-			case 2: // bool
-				cout << "\033[1;35m" << (boost::get<bool>(pair.second) ? "true" : "false") << "\033[0m\n";
+			case gg::ConfigValue::TYPE::NONE:
 				break;
 			}
 		}
 	}
 
-	p["id"] = string("changed");
+	p.set("id", "changed");
 	cout << "\nid:        " << p["id"]
 	     << "\nnot_exist: " << p["not_exist"] << endl;
 }
@@ -51,7 +59,17 @@ void drawColors() {
 }
 
 
-int main() {
+int main(int argc, char** argv) {
+#ifdef GGCONFIG_TESTING
+	if (argc == 2 && string(argv[1]) == "test") {
+		runAllTests();
+		return 0;
+	}
+#else
+	(void) argc;
+	(void) argv;
+#endif // GGCONFIG_TESTING
+
 	run();
 	// drawColors();
 }
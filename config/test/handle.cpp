@@ -0,0 +1,149 @@
+#include "../ggconfig_handle.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+#include <unistd.h>
+
+using namespace std;
+
+
+namespace {
+
+	gg::ConfigStorage makeVersion(int v) {
+		gg::ConfigStorage cs;
+		cs.set("version", static_cast<double>(v));
+		cs.set("twice", static_cast<double>(2 * v));
+		cs.set("label", "version number " + to_string(v) + " with a long label");
+		return cs;
+	}
+
+} // anon namespace
+
+
+void testHandleConcurrentReaders() {
+	constexpr int numOfVersions = 300;
+	constexpr int numOfReaders = 4;
+
+	gg::ConfigHandle handle(makeVersion(0));
+	atomic<bool> done(false);
+	atomic<int> inconsistent(0);
+	atomic<long> reads(0);
+
+	vector<thread> readers;
+	for (int r = 0; r < numOfReaders; ++r) {
+		readers.emplace_back([&]() {
+			double last = 0.0;
+			while (!done.load(memory_order_acquire)) {
+				const auto cfg = handle.read();
+				const double v = cfg->getDouble("version", -1.0);
+
+				// a version is either fully visible or not at all, and they never go backwards
+				const bool ok = cfg->getDouble("twice") == 2 * v
+				             && cfg->getString("label") == "version number " + to_string(static_cast<int>(v)) + " with a long label"
+				             && v >= last;
+				inconsistent += !ok;
+				last = v;
+				++reads;
+				this_thread::yield();
+			}
+		});
+	}
+
+	for (int v = 1; v <= numOfVersions; ++v) {
+		// let the readers in between versions, even on a single core
+		while (reads < v)
+			this_thread::yield();
+		handle.publish(makeVersion(v));
+	}
+
+	done.store(true, memory_order_release);
+	for (auto& t: readers)
+		t.join();
+
+	cout << "Versions: " << handle.version() << ", reads: " << reads << ", inconsistent reads: " << inconsistent << endl;
+	assert(inconsistent == 0 && handle.version() == numOfVersions + 1);
+	assert(handle.read()->getDouble("version") == numOfVersions);
+}
+
+
+void testHandleManyGuards() {
+	constexpr size_t numOfGuards = 3 * gg::ConfigHandle::MAX_READERS + 10;
+
+	gg::ConfigHandle handle(makeVersion(0));
+
+	// more guards than reader slots: the rest go into overflow slots instead of spinning
+	vector<gg::ConfigHandle::ReadGuard> guards;
+	guards.reserve(numOfGuards);
+	for (size_t i = 0; i < numOfGuards; ++i)
+		guards.push_back(handle.read());
+
+	// the writer has to wait for every one of them, overflow slots included
+	atomic<bool> published(false);
+	thread writer([&]() {
+		handle.publish(makeVersion(1));
+		published.store(true, memory_order_release);
+	});
+
+	this_thread::sleep_for(chrono::milliseconds(20));
+	int wrongValues = 0;
+	for (const auto& g: guards)
+		wrongValues += g->getDouble("version", -1.0) != 0.0;
+	assert(!published.load(memory_order_acquire));
+
+	// the last ones taken sit in overflow slots; the first are still held
+	while (guards.size() > gg::ConfigHandle::MAX_READERS / 2)
+		guards.pop_back();
+	this_thread::sleep_for(chrono::milliseconds(20));
+	assert(!published.load(memory_order_acquire));
+
+	guards.clear();
+	writer.join();
+
+	cout << "Guards: " << numOfGuards << ", wrong values: " << wrongValues << ", version after release: " << handle.read()->getDouble("version") << endl;
+	assert(wrongValues == 0 && published && handle.read()->getDouble("version") == 1.0);
+}
+
+
+void testHandleWatch() {
+	const string path = "/tmp/ggconfig_watch_test.ggconfig";
+	ofstream(path) << "value = 1\n";
+
+	gg::ConfigHandle handle;
+	assert(handle.reload(path.c_str()) && handle.read()->getDouble("value") == 1.0);
+
+	if (!handle.watch(path.c_str())) {
+		cout << "File watching is not available, skipped." << endl;
+		unlink(path.c_str());
+		return;
+	}
+
+	const auto waitForVersion = [&handle](uint64_t v) {
+		for (int i = 0; i < 200 && handle.version() < v; ++i)
+			this_thread::sleep_for(chrono::milliseconds(10));
+		return handle.version() >= v;
+	};
+
+	// replaced the way editors do it: write a temp file, then rename it over the original
+	const uint64_t before = handle.version();
+	ofstream(path + ".new") << "value = 2\n";
+	rename((path + ".new").c_str(), path.c_str());
+	assert(waitForVersion(before + 1));
+
+	cout << "Reloaded after rename: value = " << handle.read()->getDouble("value") << endl;
+	assert(handle.read()->getDouble("value") == 2.0);
+
+	// broken files are reported and the current version stays
+	cout << "Expecting an error:" << endl;
+	assert(!handle.reload("/tmp/ggconfig_does_not_exist.ggconfig"));
+	assert(handle.read()->getDouble("value") == 2.0);
+
+	handle.unwatch();
+	unlink(path.c_str());
+}
@@ -0,0 +1,15 @@
+#ifndef GG_CONFIG_TEST_HANDLE_HPP
+#define GG_CONFIG_TEST_HANDLE_HPP
+
+
+/* Reader threads check that every version they see is complete while a writer keeps publishing */
+void testHandleConcurrentReaders();
+
+/* More guards than reader slots are alive at once; a writer waits for all of them */
+void testHandleManyGuards();
+
+/* A watched file is reloaded after it's replaced; a broken file keeps the old version */
+void testHandleWatch();
+
+
+#endif // GG_CONFIG_TEST_HANDLE_HPP
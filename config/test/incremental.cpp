@@ -0,0 +1,134 @@
+#include "incremental.hpp"
+#include "parse.hpp"
+#include "../ggconfig_incremental.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <cassert>
+
+using namespace std;
+
+
+namespace {
+
+	bool sameAsFullParse(const gg::IncrementalConfig& inc) {
+		gg::ConfigStorage full;
+		if (!parseText(full, inc.text()) || full.storage.size() != inc.storage().storage.size())
+			return false;
+
+		for (const auto& e: full.storage) {
+			if (inc.storage()[e.key()] != e.value)
+				return false;
+		}
+
+		return true;
+	}
+
+} // anon namespace
+
+
+void testIncrementalDifferential() {
+	// few distinct keys, so there are plenty of redefinitions
+	mt19937 rng(42);
+	const auto pick = [&rng](size_t n) { return uniform_int_distribution<size_t>(0, n - 1)(rng); };
+	const auto statement = [&]() {
+		const string key = "k" + to_string(pick(40));
+		switch (pick(5)) {
+		case 0:  return key + " = " + to_string(pick(1000)) + "\n";
+		case 1:  return key + " = \"str " + to_string(pick(1000)) + " \\\"esc\\\"\"\n";
+		case 2:  return key + " = k" + to_string(pick(40)) + " = true # chained\n";
+		case 3:  return "# comment with a \" quote\n" + key + " = \"multi\nline\"\n";
+		default: return key + "=false ";
+		}
+	};
+
+	string text;
+	for (int i = 0; i < 200; ++i)
+		text += statement();
+
+	gg::IncrementalConfig inc;
+	assert(inc.update(text) && sameAsFullParse(inc));
+
+	cout << "Expecting errors from the rejected edits:" << endl;
+
+	size_t accepted = 0, rejected = 0, rescans = 0;
+	for (int round = 0; round < 400; ++round) {
+		const string before = inc.text();
+		const size_t at = pick(before.size() + 1);
+		const size_t removed = pick(min<size_t>(before.size() - at, 30) + 1);
+
+		// mostly whole statements, sometimes random bytes that may break the syntax
+		string inserted;
+		switch (pick(4)) {
+		case 0:  inserted = statement(); break;
+		case 1:  inserted = string(1, "0123456789\" #=\nab"[pick(17)]); break;
+		case 2:  break;
+		default: inserted = " " + statement(); break;
+		}
+
+		const bool ok = round % 2 == 0 ? inc.edit(at, removed, inserted) : inc.update(before.substr(0, at) + inserted + before.substr(at + removed));
+		if (ok) {
+			++accepted;
+			rescans += inc.lastUpdate().rescanned;
+		} else {
+			++rejected;
+			assert(inc.text() == before);
+		}
+
+		assert(sameAsFullParse(inc));
+	}
+
+	cout << "Edits: " << accepted << " accepted, " << rejected << " rejected (syntax errors), " << rescans << " needed a scan" << endl;
+}
+
+
+void testIncrementalLocality() {
+	string text;
+	for (int i = 0; text.size() < 4 * 1024 * 1024; ++i)
+		text += "key" + to_string(i) + " = \"value number " + to_string(i) + "\" num" + to_string(i) + " = " + to_string(i) + "\n";
+
+	gg::IncrementalConfig inc;
+	assert(inc.update(text));
+
+	// the first edit that grows the text reallocates it; later ones only move the bytes after the edit
+	const size_t at = inc.text().find("num50000 = 50000") + 11;
+	assert(inc.edit(at, 5, "-2.5e3"));
+
+	const auto start = chrono::steady_clock::now();
+	assert(inc.edit(at, 6, "-1.5e3"));
+	const double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+	cout << "Edit in a " << inc.text().size() / 1024 << " KiB file (" << inc.statements() << " statements): "
+	     << ms << " ms, reparsed " << inc.lastUpdate().reparsedBytes << " bytes" << endl;
+
+	assert(inc.storage().getDouble("num50000") == -1500 && inc.lastUpdate().reparsedStatements == 1);
+	assert(inc.lastUpdate().reparsedBytes < 64 && !inc.lastUpdate().rescanned);
+	assert(sameAsFullParse(inc));
+}
+
+
+void testIncrementalArena() {
+	constexpr int numOfEdits = 20000;
+
+	string text;
+	for (int i = 0; i < 100; ++i)
+		text += "key" + to_string(i) + " = \"a string too long to be stored inline " + to_string(i) + "\"\n";
+
+	gg::IncrementalConfig inc;
+	assert(inc.update(text));
+	const size_t initial = inc.storage().stringBytes();
+
+	// every edit replaces a long string; the replaced ones must not pile up in the arena
+	size_t peak = 0;
+	for (int i = 0; i < numOfEdits; ++i) {
+		const size_t at = inc.text().find("inline ") + 7;
+		assert(inc.edit(at, 1, string(1, static_cast<char>('0' + i % 10))));
+		peak = max(peak, inc.storage().stringBytes());
+	}
+
+	cout << "String bytes: " << initial << " at first, " << inc.storage().stringBytes() << " after " << numOfEdits << " edits, peak " << peak << endl;
+	assert(peak <= 3 * initial && sameAsFullParse(inc));
+}
@@ -0,0 +1,15 @@
+#ifndef GG_CONFIG_TEST_INCREMENTAL_HPP
+#define GG_CONFIG_TEST_INCREMENTAL_HPP
+
+
+/* Random edits, each compared against parsing the edited text from scratch */
+void testIncrementalDifferential();
+
+/* A small edit in a big file only reparses the statements around it */
+void testIncrementalLocality();
+
+/* Replaced strings don't keep growing the arena */
+void testIncrementalArena();
+
+
+#endif // GG_CONFIG_TEST_INCREMENTAL_HPP
@@ -0,0 +1,291 @@
+#include "parse.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace std;
+
+
+bool parseText(gg::ConfigStorage& cs, const string& text, const gg::ParseOptions& options) {
+	char path[] = "/tmp/ggconfig_test_XXXXXX";
+	const int fd = mkstemp(path);
+	assert(fd != -1);
+	close(fd);
+	ofstream(path, ios::binary) << text;
+
+	// lazy storages keep the file mapped, so it can be unlinked right away
+	const bool ok = cs.parseFile(path, options);
+	unlink(path);
+	return ok;
+}
+
+
+void testParseNumbers() {
+	gg::ConfigStorage cs;
+	const bool ok = parseText(cs,
+		"a = 42\n"
+		"b = -3.5 c = +2e3\n"
+		"d = .25# comment right after the number\n"
+		"e = 1e-3\t h = -inf\n"
+		"g = 5."
+	);
+	assert(ok);
+
+	const auto num = [&cs](const char* key) { assert(cs[key].isNumber()); return cs[key].asNumber(); };
+	cout << "a = " << num("a") << ", b = " << num("b") << ", c = " << num("c") << ", d = " << num("d")
+	     << ", e = " << num("e") << ", h = " << num("h") << ", g = " << num("g") << endl;
+
+	assert(num("a") == 42.0 && num("b") == -3.5 && num("c") == 2000.0 && num("d") == 0.25);
+	assert(num("e") == 1e-3 && std::isinf(num("h")) && num("h") < 0 && num("g") == 5.0);
+
+	const char* malformed[] = {"x = 1.2.3\n", "x = 1e999\n", "x = ++1\n", "x = 0x10\n", "x = 5\"a\"\n", "x = -\n"};
+	for (const char* text: malformed) {
+		gg::ConfigStorage bad;
+		cout << "Expecting an error for: " << text << flush;
+		assert(!parseText(bad, text));
+	}
+}
+
+
+void testParseEvents() {
+	const string text =
+		"a = b = \"plain\"  # comment\n"
+		"esc = \"say \\\"hi\\\"\"\n"
+		"f = 1 t = true\n"
+		"trueish = false\n";
+	const char* begin = text.data();
+	const char* end = begin + text.size();
+
+	const auto inInput = [begin, end](string_view v) { return v.data() >= begin && v.data() + v.size() <= end; };
+
+	vector<string> seen;
+	const bool ok = gg::parseConfig(begin, end, [&](const vector<string_view>& keys, const gg::RawValue& value) {
+		string line;
+		for (const auto& k: keys) {
+			assert(inInput(k));
+			line.append(k).append(" = ");
+		}
+
+		assert(inInput(value.text));
+		line.append(value.text);
+		if (value.escaped)
+			line.append(" (escaped)");
+
+		cout << line << endl;
+		seen.push_back(line);
+		return true;
+	});
+	assert(ok);
+
+	const vector<string> expected = {
+		"a = b = plain",
+		"esc = say \\\"hi\\\" (escaped)",
+		"f = 1",
+		"t = true",
+		"trueish = false"
+	};
+	assert(seen == expected);
+
+	string unescaped;
+	gg::unescape("say \\\"hi\\\" \\n \\q", unescaped);
+	assert(unescaped == "say \"hi\" \n \\q");
+
+	// the storage is built from the same events
+	gg::ConfigStorage cs;
+	assert(parseText(cs, text));
+	assert(cs.getString("a") == "plain" && cs.getString("b") == "plain" && cs.getString("esc") == "say \"hi\"");
+	assert(cs.getDouble("f") == 1.0 && cs.getBool("t") && !cs.getBool("trueish", true));
+
+	// returning false stops the scan, without an error
+	size_t count = 0;
+	assert(gg::parseConfig(begin, end, [&count](const vector<string_view>&, const gg::RawValue&) { return ++count < 2; }));
+	assert(count == 2);
+}
+
+
+void testParseLazy() {
+	const string text =
+		"short = \"abc\" long = \"a string that is too long to be stored inline\"\n"
+		"escaped = \"tab\\there, quote\\\" there\" num = -1.5e3 flag = true\n"
+		"a = b = \"chained \\\\ and escaped\"\n"
+		"short = \"redefined\"\n";
+
+	gg::ConfigStorage eager, lazy;
+	gg::ParseOptions options;
+	options.lazy = true;
+
+	assert(parseText(eager, text) && parseText(lazy, text, options));
+	assert(eager.storage.size() == lazy.storage.size());
+
+	for (const auto& e: eager.storage) {
+		cout << e.key() << " = " << lazy[e.key()] << endl;
+		assert(lazy[e.key()] == e.value);
+	}
+
+	// moving the storage keeps the mapping and the decoded strings
+	gg::ConfigStorage moved(std::move(lazy));
+	assert(moved.getString("escaped") == "tab\there, quote\" there" && moved.getString("b") == "chained \\ and escaped");
+}
+
+
+void testParseChained() {
+	const string longValue(1000, 'v');
+	const string text =
+		"a = b = c = \"" + longValue + "\"\n"
+		"d = e = \"escaped\\t" + longValue + "\"\n"
+		"b = \"redefined\"\n";
+
+	gg::ParseOptions lazyOptions;
+	lazyOptions.lazy = true;
+
+	for (const auto& options: {gg::ParseOptions(), lazyOptions}) {
+		gg::ConfigStorage cs;
+		assert(parseText(cs, text, options));
+
+		// one copy of the bytes, shared by every key of the chain
+		assert(cs.getString("a") == longValue && cs.getString("a").data() == cs.getString("c").data());
+		assert(cs.getString("d") == "escaped\t" + longValue && cs.getString("d").data() == cs.getString("e").data());
+		assert(cs.getString("b") == "redefined" && cs.getString("c") == longValue);
+	}
+
+	cout << "Chained keys share their value (eager and lazy)." << endl;
+}
+
+
+void testParseParallel() {
+	// a few MB of statements, with quotes in comments, '#' and line ends in strings, and redefinitions
+	string text;
+	for (int i = 0; text.size() < 3 * 1024 * 1024; ++i) {
+		const string n = to_string(i);
+		text += "key" + n + " = " + n + ".5 # \"not a string\n";
+		text += "str" + to_string(i % 1000) + " = \"value " + n + " # not a comment\nsecond line\"\n";
+		text += "flag" + to_string(i % 777) + " = " + (i % 2 == 0 ? "true" : "false") + "\n";
+	}
+
+	// a string that looks like statements inside, long enough to contain a cut
+	string fake;
+	while (fake.size() < 2 * 1024 * 1024)
+		fake += "fake = \\\"not a value\\\"\n";
+	text += "big = \"" + fake + "\"\nlast = 1\n";
+
+	gg::ConfigStorage sequential;
+	assert(parseText(sequential, text));
+
+	for (unsigned threads: {2u, 4u, 7u}) {
+		for (bool lazy: {false, true}) {
+			gg::ParseOptions options;
+			options.threads = threads;
+			options.lazy = lazy;
+
+			gg::ConfigStorage parallel;
+			assert(parseText(parallel, text, options));
+			assert(parallel.storage.size() == sequential.storage.size());
+			for (const auto& e: sequential.storage)
+				assert(parallel[e.key()] == e.value);
+		}
+	}
+
+	cout << "Parallel parsing matches sequential parsing: " << sequential.storage.size() << " keys, " << text.size() / 1024 << " KiB" << endl;
+	assert(sequential["fake"].isNull() && sequential.getDouble("last") == 1.0);
+
+	// errors are reported the same way
+	cout << "Expecting an error:" << endl;
+	gg::ParseOptions options;
+	options.threads = 4;
+	gg::ConfigStorage bad;
+	assert(!parseText(bad, text + "broken = =\n", options));
+}
+
+
+void testParseStream() {
+	// everything that can span a block boundary: long strings and comments, chains, numbers ended by a comment
+	string text;
+	for (int i = 0; i < 300; ++i) {
+		const string n = to_string(i);
+		text += "key" + n + " = " + n + ".25# \"not a string\n";
+		text += "str" + to_string(i % 50) + " = \"value " + n + " # not a comment\nsecond \\\"line\\\"\"\n";
+		text += "a" + n + " = b" + n + " =\n c" + n + " = " + (i % 2 == 0 ? "true" : "false") + "\n";
+		if (i % 60 == 0)
+			text += "long" + n + " = \"" + string(500, 'x') + "\"\n# " + string(300, '#') + "\n";
+	}
+	text += "last=1";
+
+	gg::ConfigStorage expected;
+	assert(parseText(expected, text));
+
+	mt19937 rng(3);
+	for (size_t blockSize: {size_t(1), size_t(16), size_t(64), size_t(1000), gg::ConfigStorage::STREAM_BLOCK_SIZE}) {
+		// reads of random sizes, like a pipe would give
+		size_t pos = 0;
+		const auto read = [&](char* buffer, size_t capacity) -> ptrdiff_t {
+			const size_t n = min({capacity, text.size() - pos, size_t(1) + rng() % 100});
+			memcpy(buffer, text.data() + pos, n);
+			pos += n;
+			return static_cast<ptrdiff_t>(n);
+		};
+
+		gg::ConfigStorage streamed;
+		assert(streamed.parseStream(read, blockSize));
+		assert(streamed.storage.size() == expected.storage.size());
+		for (const auto& e: expected.storage)
+			assert(streamed[e.key()] == e.value);
+	}
+
+	// from memory, eagerly and lazily
+	for (bool lazy: {false, true}) {
+		gg::ParseOptions options;
+		options.lazy = lazy;
+
+		gg::ConfigStorage buffered;
+		assert(buffered.parseBuffer(text, options));
+		assert(buffered.storage.size() == expected.storage.size());
+		for (const auto& e: expected.storage)
+			assert(buffered[e.key()] == e.value);
+	}
+
+	// through a pipe
+	int fds[2];
+	assert(pipe(fds) == 0);
+	thread writer([&text, fds]() {
+		for (size_t done = 0; done < text.size(); ) {
+			const ssize_t n = write(fds[1], text.data() + done, text.size() - done);
+			assert(n > 0);
+			done += static_cast<size_t>(n);
+		}
+		close(fds[1]);
+	});
+
+	gg::ConfigStorage piped;
+	const bool pipedOk = piped.parseStream(fds[0]);
+	writer.join();
+	close(fds[0]);
+	assert(pipedOk && piped.storage.size() == expected.storage.size() && piped.getDouble("last") == 1.0);
+
+	cout << "Streamed, buffered and piped parsing match: " << expected.storage.size() << " keys, " << text.size() << " bytes" << endl;
+
+	// errors in a later block report the line of the whole stream
+	const string broken = text + "\nfine = 1\nbroken = =\nfine = 2\n";
+	size_t pos = 0;
+	const auto read = [&](char* buffer, size_t capacity) -> ptrdiff_t {
+		const size_t n = min(capacity, broken.size() - pos);
+		memcpy(buffer, broken.data() + pos, n);
+		pos += n;
+		return static_cast<ptrdiff_t>(n);
+	};
+
+	cout << "Expecting an error in line " << 1 + count(broken.begin(), broken.begin() + broken.find("broken"), '\n') << ":" << endl;
+	gg::ConfigStorage bad;
+	assert(!bad.parseStream(read, 64));
+	assert(bad.getDouble("fine") == 1.0);
+	assert(!bad.parseStream([](char*, size_t) -> ptrdiff_t { return -1; }));
+}
@@ -0,0 +1,31 @@
+#ifndef GG_CONFIG_TEST_PARSE_HPP
+#define GG_CONFIG_TEST_PARSE_HPP
+
+#include "../ggconfig.hpp"
+
+#include <string>
+
+
+/* Parse a config from a string (goes through a temp file) */
+bool parseText(gg::ConfigStorage& cs, const std::string& text, const gg::ParseOptions& options = gg::ParseOptions());
+
+/* Numbers in every supported notation, and malformed ones */
+void testParseNumbers();
+
+/* Callback parsing: views into the input, key chains, escapes, stopping early */
+void testParseEvents();
+
+/* Lazy parsing gives the same values as eager parsing */
+void testParseLazy();
+
+/* Chained keys share one stored value; redefining one of them leaves the others alone */
+void testParseChained();
+
+/* Parallel parsing matches sequential parsing, also when a chunk is cut inside a string or a comment */
+void testParseParallel();
+
+/* Parsing from memory and from streams read in blocks matches parsing the file */
+void testParseStream();
+
+
+#endif // GG_CONFIG_TEST_PARSE_HPP
@@ -0,0 +1,111 @@
+#include "../ggconfig.hpp"
+#include "../ggconfig_scan.hpp"
+
+#include <string>
+#include <vector>
+#include <random>
+#include <fstream>
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace std;
+
+
+void testScanDifferential() {
+	// biased towards the chars the scanners stop at
+	const string alphabet = "  \t\n\r\v\f\"\\#=ab_1.\x7f\x80\xff";
+	constexpr size_t bufSize = 300;
+	constexpr int rounds = 200;
+
+	mt19937 rng(2017);
+	uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+	uniform_int_distribution<int> runLength(0, 80);
+
+	int mismatches = 0;
+	size_t checks = 0;
+
+	for (int r = 0; r < rounds; ++r) {
+		// long runs of one char exercise the full-width loops, single chars the tails
+		string buf;
+		while (buf.size() < bufSize)
+			buf.append(runLength(rng) % 3 == 0 ? runLength(rng) : 1, alphabet[pick(rng)]);
+		buf.resize(bufSize);
+
+		const char* data = buf.data();
+		for (size_t b = 0; b < bufSize; ++b) {
+			for (size_t e = b; e <= bufSize; e += 1 + (e - b) / 8) {
+				const char* p = data + b;
+				const char* end = data + e;
+
+				mismatches += gg::scan::findNewline(p, end) != gg::scan::scalar::findNewline(p, end);
+				mismatches += gg::scan::findQuoteOrBackslash(p, end) != gg::scan::scalar::findQuoteOrBackslash(p, end);
+				mismatches += gg::scan::skipSpace(p, end) != gg::scan::scalar::skipSpace(p, end);
+				mismatches += gg::scan::countNewlines(p, end) != gg::scan::scalar::countNewlines(p, end);
+				checks += 4;
+			}
+		}
+	}
+
+	cout << "Mismatches: " << mismatches << " out of " << checks << " checks" << endl;
+	assert(mismatches == 0);
+}
+
+
+void testScanParse() {
+	constexpr int numOfKeys = 2000;
+
+	mt19937 rng(42);
+	uniform_int_distribution<int> len(0, 200);
+	uniform_int_distribution<int> coin(0, 3);
+
+	vector<string> expected;
+	string text;
+
+	for (int i = 0; i < numOfKeys; ++i) {
+		// comment and whitespace noise between statements
+		if (coin(rng) == 0)
+			text.append("# comment ").append(len(rng), 'c').append(" \"quote\" \\ = #\n");
+		text.append(len(rng) % 7, coin(rng) ? ' ' : '\n');
+
+		string raw, value;
+		const int n = len(rng);
+		for (int c = 0; c < n; ++c) {
+			switch (coin(rng) * 4 + coin(rng)) {
+			case 0:  raw += "\\\\"; value += '\\';  break;
+			case 1:  raw += "\\\"";  value += '"';   break;
+			case 2:  raw += "\\n";   value += '\n';  break;
+			case 3:  raw += "\\t";   value += '\t';  break;
+			case 4:  raw += "\\x";   value += "\\x"; break;
+			case 5:  raw += '\n';    value += '\n';  break;
+			default: raw += static_cast<char>('a' + c % 26); value += raw.back(); break;
+			}
+		}
+
+		text.append("key_").append(to_string(i)).append(" =\t\"").append(raw).append("\"");
+		expected.push_back(value);
+	}
+	text += '\n';
+
+	char path[] = "/tmp/ggconfig_scan_XXXXXX";
+	const int fd = mkstemp(path);
+	assert(fd != -1);
+	close(fd);
+	ofstream(path, ios::binary) << text;
+
+	gg::ConfigStorage cs;
+	const bool ok = cs.parseFile(path);
+	unlink(path);
+	assert(ok);
+
+	int wrongValues = 0;
+	for (int i = 0; i < numOfKeys; ++i) {
+		const auto& v = cs["key_" + to_string(i)];
+		if (!v.isString() || v.asString() != expected[i])
+			++wrongValues;
+	}
+
+	cout << "Parsed " << text.size() << " bytes, wrong values: " << wrongValues << " out of " << numOfKeys << endl;
+	assert(wrongValues == 0);
+}
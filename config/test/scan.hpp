@@ -0,0 +1,12 @@
+#ifndef GG_CONFIG_TEST_SCAN_HPP
+#define GG_CONFIG_TEST_SCAN_HPP
+
+
+/* Compare the vectorized scanning routines with the scalar ones on random buffers */
+void testScanDifferential();
+
+/* Parse generated configs full of comments, whitespace and long strings, then check every value */
+void testScanParse();
+
+
+#endif // GG_CONFIG_TEST_SCAN_HPP
@@ -0,0 +1,133 @@
+#include "../ggconfig.hpp"
+#include "../ggconfig_snapshot.hpp"
+
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <cassert>
+#include <unistd.h>
+
+using namespace std;
+
+
+static const char* const snapshotPath = "/tmp/ggconfig_test.snapshot";
+
+
+void testSnapshotRoundTrip() {
+	constexpr int numOfKeys = 5000;
+
+	gg::ConfigStorage cs;
+	for (int i = 0; i < numOfKeys; ++i) {
+		const string key = "key_" + to_string(i);
+		switch (i % 4) {
+		case 0: cs.set(key, static_cast<double>(i) / 8); break;
+		case 1: cs.set(key, i % 3 == 0); break;
+		case 2: cs.set(key, "short" + to_string(i)); break;
+		case 3: cs.set(key, string(16 + i % 50, static_cast<char>('a' + i % 26))); break;
+		}
+	}
+	cs.set("empty", "");
+
+	assert(cs.saveSnapshot(snapshotPath));
+
+	gg::ConfigSnapshot snap;
+	assert(snap.open(snapshotPath));
+
+	int wrongValues = 0;
+	size_t visited = 0;
+	snap.forEach([&](string_view key, const gg::ConfigValue& value) {
+		++visited;
+		wrongValues += cs[key] != value;
+	});
+	for (int i = 0; i < numOfKeys; ++i) {
+		const string key = "key_" + to_string(i);
+		wrongValues += snap[key] != cs[key];
+	}
+
+	cout << "Snapshot entries: " << snap.size() << ", visited: " << visited << ", wrong values: " << wrongValues << endl;
+	assert(wrongValues == 0 && snap.size() == cs.storage.size() && visited == cs.storage.size());
+	assert(snap[GG_KEY("key_0")].asNumber(-1.0) == 0.0 && snap.getString("empty", "x") == "" && snap["missing"].isNull());
+
+	// a moved-from snapshot is closed, the moved-to one keeps the mapping
+	gg::ConfigSnapshot moved(std::move(snap));
+	assert(!snap.isOpen() && snap.size() == 0 && snap["key_0"].isNull());
+	assert(moved.isOpen() && moved.size() == cs.storage.size() && moved["key_2"] == cs["key_2"]);
+	snap = std::move(moved);
+	assert(!moved.isOpen() && moved["key_2"].isNull() && snap["key_2"] == cs["key_2"]);
+
+	gg::ConfigStorage loaded;
+	assert(loaded.loadSnapshot(snapshotPath));
+	for (const auto& e: cs.storage)
+		wrongValues += loaded[e.key()] != e.value;
+
+	cout << "Loaded back: " << loaded.storage.size() << " entries, wrong values: " << wrongValues << endl;
+	assert(wrongValues == 0 && loaded.storage.size() == cs.storage.size());
+
+	// null values are left out, keys and all
+	gg::ConfigStorage withNull;
+	withNull.set("kept", 1.0);
+	withNull.storage["null_value"];
+	assert(withNull.saveSnapshot(snapshotPath));
+
+	gg::ConfigSnapshot nulls;
+	assert(nulls.open(snapshotPath));
+	gg::snapshot::Header header;
+	ifstream(snapshotPath, ios::binary).read(reinterpret_cast<char*>(&header), sizeof(header));
+	assert(nulls.size() == 1 && nulls["kept"].asNumber() == 1.0 && nulls["null_value"].isNull() && header.poolSize == 4);
+
+	unlink(snapshotPath);
+}
+
+
+void testSnapshotCorrupt() {
+	gg::ConfigStorage cs;
+	cs.set("a", "some string value that goes into the pool");
+	cs.set("b", 2.0);
+	assert(cs.saveSnapshot(snapshotPath));
+
+	string bytes;
+	{
+		ifstream in(snapshotPath, ios::binary);
+		bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+	}
+
+	const auto opens = [](const string& contents, bool verify) {
+		ofstream(snapshotPath, ios::binary | ios::trunc) << contents;
+		gg::ConfigSnapshot snap;
+		return snap.open(snapshotPath, verify);
+	};
+
+	string flipped = bytes;
+	flipped.back() ^= 1;
+
+	cout << "Expecting errors:" << endl;
+	assert(opens(bytes, true));
+	assert(!opens(bytes.substr(0, bytes.size() - 1), true));
+	assert(!opens(flipped, true));
+	assert(opens(flipped, false));   // without the checksum only the layout is checked
+	// every slot taken: a lookup of a missing key still has to stop
+	gg::snapshot::Header header;
+	memcpy(&header, bytes.data(), sizeof(header));
+	string full = bytes;
+	for (uint64_t i = 0; i < header.slotCount; ++i) {
+		gg::snapshot::Slot slot;
+		char* at = &full[header.indexOffset + i * sizeof(slot)];
+		memcpy(&slot, at, sizeof(slot));
+		if (slot.type == gg::snapshot::SLOT_EMPTY) {
+			slot.hash = 0x1234;
+			slot.type = gg::snapshot::SLOT_BOOL;
+			memcpy(at, &slot, sizeof(slot));
+		}
+	}
+	{
+		ofstream(snapshotPath, ios::binary | ios::trunc) << full;
+		gg::ConfigSnapshot snap;
+		assert(snap.open(snapshotPath, false));
+		assert(snap["missing"].isNull() && snap["b"].asNumber() == 2.0);
+	}
+
+	assert(!opens("not a snapshot at all, just some text that is long enough for a header....", true));
+
+	unlink(snapshotPath);
+}
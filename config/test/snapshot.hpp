@@ -0,0 +1,12 @@
+#ifndef GG_CONFIG_TEST_SNAPSHOT_HPP
+#define GG_CONFIG_TEST_SNAPSHOT_HPP
+
+
+/* Save a storage, query the snapshot in place and load it back */
+void testSnapshotRoundTrip();
+
+/* Truncated and corrupted files are rejected */
+void testSnapshotCorrupt();
+
+
+#endif // GG_CONFIG_TEST_SNAPSHOT_HPP
@@ -0,0 +1,81 @@
+#include "../ggconfig_stack.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <cassert>
+#include <unistd.h>
+
+using namespace std;
+
+
+namespace {
+
+	shared_ptr<gg::ConfigStorage> makeLayer(const string& name, double port) {
+		auto layer = make_shared<gg::ConfigStorage>();
+		layer->set("name", name);
+		layer->set(name + "_only", true);
+		layer->set("port", port);
+		return layer;
+	}
+
+} // anon namespace
+
+
+void testStackOverlay() {
+	auto base = makeLayer("base", 80);
+	auto env = makeLayer("env", 8080);
+	auto host = make_shared<gg::ConfigStorage>();
+	host->set("name", "host");
+
+	base->set("timeout", 30.0);
+
+	gg::ConfigStack stack;
+	stack.push(base);
+	stack.push(env);
+	stack.push(host);
+
+	cout << "name = " << stack["name"] << ", port = " << stack["port"] << ", timeout = " << stack["timeout"] << endl;
+	assert(stack.getString("name") == "host" && stack.getDouble(GG_KEY("port")) == 8080 && stack.getDouble("timeout") == 30);
+	assert(stack.getBool("base_only") && stack.getBool("env_only") && stack["missing"].isNull());
+
+	// nothing is copied: the values live in the layers
+	assert(stack.find("port") == env->find("port") && stack.find("timeout") == base->find("timeout"));
+
+	// hits are cached, misses aren't
+	assert(stack.cachedKeys() == 5);
+	for (int i = 0; i < 1000; ++i)
+		assert(stack.find("missing" + to_string(i)) == nullptr);
+	assert(stack.getDouble("port") == 8080 && stack.cachedKeys() == 5);
+
+	// the same layers in another order, in another stack
+	gg::ConfigStack other;
+	other.push(env);
+	other.push(base);
+	assert(other.getString("name") == "base" && other.getDouble("port") == 80);
+	assert(base.use_count() == 3 && env.use_count() == 3);
+}
+
+
+void testStackReload() {
+	const string path = "/tmp/ggconfig_stack_test.ggconfig";
+	ofstream(path) << "name = \"from file\"\nport = 1\n";
+
+	gg::ConfigStack stack;
+	stack.push(makeLayer("base", 80));
+	assert(stack.pushFile(path.c_str()) && stack.size() == 2);
+	assert(stack.getString("name") == "from file" && stack.getDouble("port") == 1);
+
+	// the cache follows the layers
+	ofstream(path) << "port = 2\n";
+	assert(stack.reload(1, path.c_str()) && stack.cachedKeys() == 0);
+	assert(stack.getString("name") == "base" && stack.getDouble("port") == 2);
+
+	stack.replace(0, makeLayer("replaced", 3));
+	assert(stack.getString("name") == "replaced" && stack.getDouble("port") == 2);
+
+	cout << "Expecting an error:" << endl;
+	unlink(path.c_str());
+	assert(!stack.reload(1, path.c_str()) && stack.getDouble("port") == 2);
+}
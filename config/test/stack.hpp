@@ -0,0 +1,12 @@
+#ifndef GG_CONFIG_TEST_STACK_HPP
+#define GG_CONFIG_TEST_STACK_HPP
+
+
+/* Lookups resolve top-down, point into the layers, and layers are shared between stacks */
+void testStackOverlay();
+
+/* Replacing or reloading a layer drops the cached resolutions */
+void testStackReload();
+
+
+#endif // GG_CONFIG_TEST_STACK_HPP
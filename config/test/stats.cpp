@@ -0,0 +1,141 @@
+#include "stats.hpp"
+#include "parse.hpp"
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <cassert>
+
+using namespace std;
+
+
+namespace {
+
+	uint64_t profiledBytes(const gg::ConfigStats& stats) {
+		uint64_t total = 0;
+		for (size_t i = 0; i < gg::PARSER_STATE_COUNT; ++i)
+			total += stats.stateBytes(static_cast<gg::ParserState>(i));
+		return total;
+	}
+
+} // anon namespace
+
+
+void testStatsLookups() {
+	gg::ConfigStorage cs;
+	cs.set("host", "localhost");
+	cs.set("port", 8080.0);
+	cs.set("debug", false);
+	cs.set("unused.one", 1.0);
+	cs.set("unused.two", 2.0);
+
+	gg::ConfigStats stats;
+	cs.attachStats(&stats);
+	assert(cs.attachedStats() == &stats);
+
+	// every kind of lookup is counted, from several threads at once
+	constexpr int numOfThreads = 4;
+	constexpr int rounds = 10000;
+	vector<thread> threads;
+	for (int t = 0; t < numOfThreads; ++t) {
+		threads.emplace_back([&cs]() {
+			const string_view batch[] = {"host", "missing \"quoted\""};
+			gg::ConfigValue out[2];
+
+			for (int i = 0; i < rounds; ++i) {
+				assert(cs.getDouble("port") == 8080.0);
+				assert(cs[GG_KEY("host")].isString());
+				assert(!cs.getBool("debug", true));
+				assert(cs.find("timeout") == nullptr);
+				cs.getMany(batch, 2, out);
+			}
+		});
+	}
+	for (auto& t: threads)
+		t.join();
+
+	cs.attachStats(nullptr);
+	assert(cs["port"].asNumber() == 8080.0);     // not counted anymore
+
+	const auto keys = stats.lookups();
+	cout << stats.textReport(&cs);
+
+	assert(keys.size() == 5 && keys[0].key == "host" && keys[0].hits == 2 * numOfThreads * rounds && keys[0].misses == 0);
+	assert(stats.hits() == 4u * numOfThreads * rounds && stats.misses() == 2u * numOfThreads * rounds);
+	for (const auto& k: keys) {
+		if (k.key == "timeout" || k.key == "missing \"quoted\"")
+			assert(k.hits == 0 && k.misses == numOfThreads * rounds);
+	}
+
+	const vector<string> unused = stats.unusedKeys(cs);
+	assert(unused.size() == 2 && unused[0] == "unused.one" && unused[1] == "unused.two");
+
+	const string json = stats.jsonReport(&cs);
+	cout << json << endl;
+	assert(json.front() == '{' && json.back() == '}' && json.find("\"missing \\\"quoted\\\"\"") != string::npos);
+	assert(json.find("\"unused\":[\"unused.one\",\"unused.two\"]") != string::npos);
+
+	// only so many keys are tracked, the rest is still counted in the totals
+	gg::ConfigStats small(2);
+	cs.attachStats(&small);
+	for (int i = 0; i < 10; ++i)
+		cs.find("key" + to_string(i));
+	cs.attachStats(nullptr);
+
+	assert(small.lookups().size() == 2 && small.misses() == 10);
+
+	stats.reset();
+	assert(stats.lookups().empty() && stats.hits() == 0 && stats.parses() == 0);
+}
+
+
+void testStatsParse() {
+	string text;
+	size_t numberBytes = 0;
+	for (int i = 0; text.size() < 3 * 1024 * 1024; ++i) {
+		const string number = to_string(i * 7) + ".25";
+		numberBytes += number.size();
+		text += "# comment " + to_string(i) + "\nkey" + to_string(i) + " = \"str\\\"ing\"  num" + to_string(i) + " = " + number + "\n";
+		text += "t" + to_string(i) + " = true truthy = false\n";
+	}
+
+	gg::ConfigStats stats;
+	for (unsigned threads: {1u, 3u}) {
+		stats.reset();
+
+		gg::ConfigStorage cs;
+		cs.attachStats(&stats);
+		gg::ParseOptions options;
+		options.threads = threads;
+		assert(parseText(cs, text, options));
+
+		// every byte counts for exactly one state, and numbers for theirs
+		assert(stats.parses() == 1 && stats.parsedBytes() == text.size() && profiledBytes(stats) == text.size());
+		assert(stats.stateBytes(gg::ParserState::NUM) == numberBytes);
+		assert(stats.phaseNanoseconds(gg::ConfigStats::PHASE::PARSE) != 0);
+		assert((stats.phaseNanoseconds(gg::ConfigStats::PHASE::MERGE) != 0) == (threads > 1));
+
+		cs.view();
+		assert(stats.phaseNanoseconds(gg::ConfigStats::PHASE::INDEX) != 0);
+	}
+
+	cout << stats.textReport();
+
+	// streams profile what's carried over between blocks twice, so the states add up to a little more
+	stats.reset();
+	gg::ConfigStorage streamed;
+	streamed.attachStats(&stats);
+	size_t pos = 0;
+	assert(streamed.parseStream([&](char* buffer, size_t capacity) -> ptrdiff_t {
+		const size_t n = min(capacity, text.size() - pos);
+		memcpy(buffer, text.data() + pos, n);
+		pos += n;
+		return static_cast<ptrdiff_t>(n);
+	}, 64 * 1024));
+
+	cout << "Streamed: " << stats.parsedBytes() << " bytes, " << profiledBytes(stats) << " profiled" << endl;
+	assert(stats.parsedBytes() == text.size() && profiledBytes(stats) >= text.size() && profiledBytes(stats) < text.size() * 101 / 100);
+	assert(stats.phaseNanoseconds(gg::ConfigStats::PHASE::READ) != 0);
+}
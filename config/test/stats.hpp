@@ -0,0 +1,12 @@
+#ifndef GG_CONFIG_TEST_STATS_HPP
+#define GG_CONFIG_TEST_STATS_HPP
+
+
+/* Hits and misses per key, from several threads; unused keys; keys beyond the tracked ones */
+void testStatsLookups();
+
+/* Parse profiles add up to the input, sequentially, in parallel and from streams; reports */
+void testStatsParse();
+
+
+#endif // GG_CONFIG_TEST_STATS_HPP
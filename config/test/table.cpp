@@ -0,0 +1,94 @@
+#include "../ggconfig_table.hpp"
+#include "../ggconfig.hpp"
+
+#include <string>
+#include <random>
+#include <iostream>
+#include <unordered_map>
+#include <cassert>
+
+using namespace std;
+
+
+void testTableDifferential() {
+	constexpr int numOfOps = 200000;
+	constexpr int keySpace = 20000;
+
+	gg::FlatTable<int> table;
+	unordered_map<string, int> reference;
+
+	mt19937 rng(7);
+	uniform_int_distribution<int> keyPick(0, keySpace - 1);
+	uniform_int_distribution<int> opPick(0, 9);
+
+	int mismatches = 0;
+
+	for (int i = 0; i < numOfOps; ++i) {
+		const string key = "k_" + to_string(keyPick(rng));
+
+		switch (opPick(rng)) {
+		case 0: case 1: case 2: case 3:
+			table[key] = i;
+			reference[key] = i;
+			break;
+		case 4:
+			mismatches += table.erase(key) != (reference.erase(key) == 1);
+			break;
+		default: {
+				const int* found = table.find(key);
+				const auto it = reference.find(key);
+				mismatches += (found == nullptr) != (it == reference.end()) || (found != nullptr && *found != it->second);
+			} break;
+		}
+	}
+
+	size_t iterated = 0;
+	for (const auto& e: table) {
+		++iterated;
+		const auto it = reference.find(string(e.key()));
+		mismatches += it == reference.end() || it->second != e.value;
+	}
+
+	cout << "Size: " << table.size() << " (capacity: " << table.capacity() << "), mismatches: " << mismatches << endl;
+	assert(mismatches == 0);
+	assert(table.size() == reference.size() && iterated == reference.size());
+}
+
+
+void testTableMove() {
+	constexpr int numOfKeys = 5000;
+
+	gg::FlatTable<int> table;
+	for (int i = 0; i < numOfKeys; ++i)
+		table["k_" + to_string(i)] = i;
+
+	gg::FlatTable<int> moved(std::move(table));
+	assert(table.empty() && table.capacity() == 0 && table.find("k_1") == nullptr && moved.size() == numOfKeys);
+
+	for (int i = 0; i < numOfKeys; ++i)
+		table["k_" + to_string(i)] = -i;
+	gg::FlatTable<int> assigned;
+	assigned["x"] = 1;
+	assigned = std::move(moved);
+	assert(moved.empty() && moved.find("k_1") == nullptr);
+	moved["y"] = 2;
+
+	int mismatches = 0;
+	for (int i = 0; i < numOfKeys; ++i) {
+		mismatches += table.find("k_" + to_string(i)) == nullptr || *table.find("k_" + to_string(i)) != -i;
+		mismatches += assigned.find("k_" + to_string(i)) == nullptr || *assigned.find("k_" + to_string(i)) != i;
+	}
+
+	// the same through a storage
+	gg::ConfigStorage cs;
+	cs.set("name", "a string long enough not to be stored inline");
+	gg::ConfigStorage other(std::move(cs));
+	assert(cs.storage.empty() && cs["name"].isNull());
+	cs.set("name", "another string long enough not to be stored inline");
+	cs.set("other", 1.0);
+
+	cout << "Mismatches after reusing moved-from tables: " << mismatches << endl;
+	assert(mismatches == 0 && table.size() == numOfKeys && assigned.size() == numOfKeys && moved.size() == 1);
+	assert(cs.storage.size() == 2 && other.storage.size() == 1);
+	assert(other["name"].asString() == "a string long enough not to be stored inline" && cs["name"].asString() == "another string long enough not to be stored inline");
+}
@@ -0,0 +1,12 @@
+#ifndef GG_CONFIG_TEST_TABLE_HPP
+#define GG_CONFIG_TEST_TABLE_HPP
+
+
+/* Random inserts, overwrites, erases and lookups, checked against std::unordered_map */
+void testTableDifferential();
+
+/* Moved-from tables and storages are empty, and can be filled again without touching the moved ones */
+void testTableMove();
+
+
+#endif // GG_CONFIG_TEST_TABLE_HPP
@@ -0,0 +1,122 @@
+#include "scan.hpp"
+#include "parse.hpp"
+#include "value.hpp"
+#include "table.hpp"
+#include "snapshot.hpp"
+#include "handle.hpp"
+#include "stack.hpp"
+#include "view.hpp"
+#include "incremental.hpp"
+#include "text.hpp"
+#include "stats.hpp"
+
+#include <string>
+#include <iostream>
+
+using namespace std;
+
+
+static inline void printTestSeparator(const string& title = "", bool isfirstTest = false) {
+	printf("%s------ %s ------\n", !isfirstTest ? "\n\n" : "", title.c_str());
+}
+
+
+void runAllTests() {
+	printTestSeparator("SCAN <SIMD vs scalar>", true);
+	testScanDifferential();
+
+	printTestSeparator("SCAN <parse>");
+	testScanParse();
+
+	printTestSeparator("VALUE <types>");
+	testValueTypes();
+
+	printTestSeparator("VALUE <arena>");
+	testValueArena();
+
+	printTestSeparator("VALUE <lookup>");
+	testValueLookup();
+
+	printTestSeparator("VALUE <compile time keys>");
+	testValueConfigKey();
+
+	printTestSeparator("VALUE <batched lookups>");
+	testValueBatch();
+
+	printTestSeparator("VALUE <lazy strings>");
+	testValueLazy();
+
+	printTestSeparator("TABLE <vs unordered_map>");
+	testTableDifferential();
+
+	printTestSeparator("TABLE <moves>");
+	testTableMove();
+
+	printTestSeparator("SNAPSHOT <round trip>");
+	testSnapshotRoundTrip();
+
+	printTestSeparator("SNAPSHOT <corrupt files>");
+	testSnapshotCorrupt();
+
+	printTestSeparator("TEXT <round trip>");
+	testTextRoundTrip();
+
+	printTestSeparator("TEXT <canonical>");
+	testTextCanonical();
+
+	printTestSeparator("HANDLE <concurrent readers>");
+	testHandleConcurrentReaders();
+
+	printTestSeparator("HANDLE <many guards>");
+	testHandleManyGuards();
+
+	printTestSeparator("HANDLE <watch & reload>");
+	testHandleWatch();
+
+	printTestSeparator("STACK <overlay>");
+	testStackOverlay();
+
+	printTestSeparator("STACK <reload>");
+	testStackReload();
+
+	printTestSeparator("VIEW <subtrees>");
+	testViewSubtree();
+
+	printTestSeparator("VIEW <rebuild>");
+	testViewRebuild();
+
+	printTestSeparator("INCREMENTAL <vs full parse>");
+	testIncrementalDifferential();
+
+	printTestSeparator("INCREMENTAL <locality>");
+	testIncrementalLocality();
+
+	printTestSeparator("INCREMENTAL <arena>");
+	testIncrementalArena();
+
+	printTestSeparator("STATS <lookups>");
+	testStatsLookups();
+
+	printTestSeparator("STATS <parsing>");
+	testStatsParse();
+
+	printTestSeparator("PARSE <numbers>");
+	testParseNumbers();
+
+	printTestSeparator("PARSE <events>");
+	testParseEvents();
+
+	printTestSeparator("PARSE <lazy>");
+	testParseLazy();
+
+	printTestSeparator("PARSE <chained keys>");
+	testParseChained();
+
+	printTestSeparator("PARSE <parallel>");
+	testParseParallel();
+
+	printTestSeparator("PARSE <buffers & streams>");
+	testParseStream();
+
+	puts("\n\nDone.\nAll tests succeeded!");
+}
@@ -0,0 +1,8 @@
+#ifndef GG_CONFIG_TEST_TEST_HPP
+#define GG_CONFIG_TEST_TEST_HPP
+
+
+void runAllTests();
+
+
+#endif // GG_CONFIG_TEST_TEST_HPP
@@ -0,0 +1,137 @@
+#include "text.hpp"
+#include "parse.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <iostream>
+#include <cassert>
+#include <unistd.h>
+
+using namespace std;
+
+
+static const char* const textPath = "/tmp/ggconfig_test_text.ggconfig";
+
+
+namespace {
+
+	/* Like operator==, but numbers have to match bit for bit (nan, -0) */
+	bool sameValue(const gg::ConfigValue& a, const gg::ConfigValue& b) {
+		if (a.type() != gg::ConfigValue::TYPE::NUMBER || b.type() != gg::ConfigValue::TYPE::NUMBER)
+			return a == b;
+
+		const double x = a.asNumber(), y = b.asNumber();
+		return (isnan(x) && isnan(y)) || memcmp(&x, &y, sizeof(x)) == 0;
+	}
+
+
+	size_t countDifferences(const gg::ConfigStorage& expected, const gg::ConfigStorage& actual) {
+		size_t wrong = expected.storage.size() != actual.storage.size();
+		for (const auto& e: expected.storage) {
+			const gg::ConfigValue* value = actual.find(e.key());
+			wrong += value == nullptr || !sameValue(e.value, *value);
+		}
+		return wrong;
+	}
+
+} // anon namespace
+
+
+void testTextRoundTrip() {
+	gg::ConfigStorage cs;
+
+	// strings with everything the parser treats specially
+	cs.set("empty", "");
+	cs.set("quotes", "say \"hi\"");
+	cs.set("backslashes", "C:\\path\\n\\\\");
+	cs.set("lines", "first\nsecond\n\tindented\n");
+	cs.set("comment", "# not a comment = true");
+	cs.set("utf8", "\xc3\xa1rv\xc3\xadzt\xc5\xb1r\xc5\x91");
+	cs.set("long", string(300, 'x') + "\"" + string(300, '\\'));
+
+	// numbers that only survive with the shortest exact form
+	cs.set("third", 1.0 / 3);
+	cs.set("tenth", 0.1);
+	cs.set("negative_zero", -0.0);
+	cs.set("denormal", numeric_limits<double>::denorm_min());
+	cs.set("max", numeric_limits<double>::max());
+	cs.set("lowest", numeric_limits<double>::lowest());
+	cs.set("inf", numeric_limits<double>::infinity());
+	cs.set("minus_inf", -numeric_limits<double>::infinity());
+	cs.set("nan", numeric_limits<double>::quiet_NaN());
+	cs.set("integer", 42.0);
+
+	cs.set("yes", true);
+	cs.set("no", false);
+	cs.set("dotted.key.path", 1.0);
+
+	// and plenty of random ones
+	mt19937_64 rng(7);
+	for (int i = 0; i < 20000; ++i) {
+		const string key = "random_" + to_string(i);
+		uint64_t bits = rng();
+		double number;
+		memcpy(&number, &bits, sizeof(number));
+
+		if (i % 3 == 0) {
+			string str(rng() % 40, ' ');
+			for (char& c: str)
+				c = "ab \"\\\n\t#=1"[rng() % 10];
+			cs.set(key, str);
+		} else {
+			cs.set(key, number);
+		}
+	}
+
+	const string text = cs.toText();
+
+	gg::ConfigStorage parsed;
+	assert(parseText(parsed, text));
+	const size_t wrong = countDifferences(cs, parsed);
+
+	cout << cs.storage.size() << " entries, " << text.size() << " bytes of text, wrong values after parsing it: " << wrong << endl;
+	assert(wrong == 0);
+
+	cout << text.substr(0, text.find("dotted")) << "..." << endl;
+
+	gg::ConfigStorage loaded;
+	assert(cs.saveText(textPath) && loaded.parseFile(textPath));
+	assert(countDifferences(cs, loaded) == 0);
+
+	unlink(textPath);
+}
+
+
+void testTextCanonical() {
+	gg::ConfigStorage cs;
+	assert(parseText(cs,
+		"b = 2   a=\"x\"  # comment\n"
+		"c = d = +inf\n"
+		"e = \"multi\n"
+		"line\"\n"
+		"f=true b = 1e3\n"
+	));
+
+	const string text = cs.toText();
+	cout << text;
+	assert(text ==
+		"a = \"x\"\n"
+		"b = 1000\n"
+		"c = +inf\n"
+		"d = +inf\n"
+		"e = \"multi\\nline\"\n"
+		"f = true\n"
+	);
+
+	gg::ConfigStorage again;
+	assert(parseText(again, text) && again.toText() == text);
+
+	// appends, and an empty storage writes nothing
+	string out = "# header\n";
+	gg::ConfigStorage().writeText(out);
+	cs.writeText(out);
+	assert(out == "# header\n" + text);
+}
@@ -0,0 +1,12 @@
+#ifndef GG_CONFIG_TEST_TEXT_HPP
+#define GG_CONFIG_TEST_TEXT_HPP
+
+
+/* Write a storage as text and parse it back: the same entries, bit for bit */
+void testTextRoundTrip();
+
+/* The text is canonical: sorted, and the same after another round trip */
+void testTextCanonical();
+
+
+#endif // GG_CONFIG_TEST_TEXT_HPP
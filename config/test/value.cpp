@@ -0,0 +1,187 @@
+#include "../ggconfig.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <cassert>
+
+using namespace std;
+
+
+void testValueTypes() {
+	using value_t = gg::ConfigStorage::value_t;
+	gg::StringArena arena;
+
+	const string shortStr(value_t::INLINE_CAPACITY, 's');
+	const string longStr(value_t::INLINE_CAPACITY + 1, 'l');
+
+	const value_t null;
+	const value_t num(2.5);
+	const value_t yes(true);
+	const value_t inl = value_t::makeString(shortStr, arena);
+	const value_t ext = value_t::makeString(longStr, arena);
+
+	cout << "sizeof(value_t) = " << sizeof(value_t) << "; arena bytes used: " << arena.bytesUsed() << endl;
+	assert(sizeof(value_t) == 16);
+	assert(arena.bytesUsed() == longStr.size());
+
+	assert(null.isNull() && num.isNumber() && yes.isBool() && inl.isString() && ext.isString());
+	assert(inl.asString() == shortStr && ext.asString() == longStr);
+	assert(num.asNumber() == 2.5 && yes.asBool());
+
+	// wrong type: default, no exceptions
+	assert(num.asString("dflt") == "dflt" && inl.asNumber(-1.0) == -1.0 && ext.asBool(true) && null.asNumber(3.0) == 3.0);
+
+	assert(inl == value_t::makeStringView(shortStr) && ext != inl && num == value_t(2.5) && yes != value_t(false));
+
+	stringstream out;
+	out << null << ' ' << num << ' ' << yes << ' ' << inl;
+	cout << "Printed: " << out.str() << endl;
+	assert(out.str() == "null 2.5 true " + shortStr);
+}
+
+
+void testValueArena() {
+	constexpr int numOfKeys = 20000;
+
+	gg::ConfigStorage cs;
+	for (int i = 0; i < numOfKeys; ++i)
+		cs.set("key" + to_string(i), string(20 + i % 100, static_cast<char>('a' + i % 26)));
+	cs.set("huge", string(1 << 20, 'h'));
+	cs.set("num", 1.5);
+	cs.set("flag", false);
+
+	gg::ConfigStorage moved(std::move(cs));
+
+	int wrongValues = 0;
+	for (int i = 0; i < numOfKeys; ++i)
+		wrongValues += moved["key" + to_string(i)].asString() != string(20 + i % 100, static_cast<char>('a' + i % 26));
+
+	cout << "Wrong values after move: " << wrongValues << " out of " << numOfKeys << endl;
+	assert(wrongValues == 0);
+	assert(moved["huge"].asString().size() == (1 << 20) && moved["num"].asNumber() == 1.5 && moved["flag"].isBool());
+	assert(moved["missing"].isNull());
+
+	// the moved-from storage is empty and can be filled again, without writing into the moved blocks
+	for (int i = 0; i < numOfKeys; ++i)
+		cs.set("key" + to_string(i), string(20 + i % 100, static_cast<char>('z' - i % 26)));
+	for (int i = 0; i < numOfKeys; ++i)
+		moved.set("more" + to_string(i), string(30, 'm'));
+
+	for (int i = 0; i < numOfKeys; ++i) {
+		wrongValues += moved["key" + to_string(i)].asString() != string(20 + i % 100, static_cast<char>('a' + i % 26));
+		wrongValues += cs["key" + to_string(i)].asString() != string(20 + i % 100, static_cast<char>('z' - i % 26));
+	}
+
+	cout << "Wrong values after refilling the moved-from storage: " << wrongValues << endl;
+	assert(wrongValues == 0);
+}
+
+
+void testValueLookup() {
+	gg::ConfigStorage cs;
+	cs.set("name", "a string that does not fit inline");
+	cs.set("ratio", 0.75);
+	cs.set("enabled", true);
+
+	const string key = "ratio";
+	const string_view view = "enabled";
+	const char* cstr = "name";
+
+	assert(cs[key].asNumber() == 0.75 && cs[view].asBool() && cs[cstr].isString());
+	assert(cs.find("missing") == nullptr && cs.find(cstr) == &cs[cstr]);
+
+	cout << "getString: " << cs.getString("name") << "\ngetDouble: " << cs.getDouble("ratio")
+	     << "\ngetBool:   " << cs.getBool("enabled") << endl;
+
+	assert(cs.getString("name") == "a string that does not fit inline" && cs.getDouble("ratio") == 0.75 && cs.getBool("enabled"));
+	assert(cs.getDouble("missing", 9.5) == 9.5 && cs.getString("ratio", "dflt") == "dflt" && !cs.getBool("name"));
+
+	// the null sentinel is shared and read-only
+	assert(&cs["missing"] == &gg::ConfigStorage::null && gg::ConfigStorage::null.isNull());
+}
+
+
+void testValueConfigKey() {
+	// hashed at compile time, or this wouldn't compile
+	static_assert(GG_KEY("port").hash() == gg::hashKey("port"), "GG_KEY must hash at compile time");
+	constexpr gg::ConfigKey host("host");
+	static_assert(host.name() == "host", "ConfigKey must be usable in constant expressions");
+
+	gg::ConfigStorage cs;
+	cs.set("port", 8080.0);
+	cs.set("host", "config.example.com");
+
+	cout << "port: " << cs[GG_KEY("port")] << "\nhost: " << cs.getString(host) << endl;
+
+	assert(cs[GG_KEY("port")].asNumber() == 8080.0 && cs.getDouble(GG_KEY("port")) == 8080.0);
+	assert(cs.getString(host) == "config.example.com" && cs.find(host) == cs.find("host"));
+	assert(cs[GG_KEY("missing")].isNull() && cs.getBool(GG_KEY("missing"), true));
+}
+
+
+void testValueBatch() {
+	gg::ConfigStorage cs;
+	for (int i = 0; i < 1000; ++i)
+		cs.set("key_" + to_string(i), static_cast<double>(i));
+	cs.set("name", "a string that does not fit inline");
+
+	// more than one batch, hits and misses mixed
+	vector<string> names;
+	for (int i = 0; i < 45; ++i)
+		names.push_back(i % 4 == 3 ? "missing_" + to_string(i) : "key_" + to_string(i * 21));
+	names.push_back("name");
+
+	const vector<string_view> views(names.begin(), names.end());
+	vector<gg::ConfigKey> keys;
+	for (const string& name: names)
+		keys.emplace_back(name);
+
+	vector<gg::ConfigValue> byView(names.size()), byKey(names.size());
+	cs.getMany(views.data(), views.size(), byView.data());
+	cs.getMany(keys.data(), keys.size(), byKey.data());
+
+	size_t found = 0;
+	for (size_t i = 0; i < names.size(); ++i) {
+		assert(byView[i] == cs[names[i]] && byKey[i] == cs[names[i]]);
+		found += !byView[i].isNull();
+	}
+
+	cout << "Batched lookups: " << names.size() << " keys, " << found << " found, last: " << byView.back() << endl;
+	assert(found == 35 && byKey.back().asString() == "a string that does not fit inline");
+
+	// nothing to look up, or nothing to look in
+	cs.getMany(views.data(), 0, byView.data());
+	gg::ConfigStorage().getMany(views.data(), views.size(), byView.data());
+	assert(byView.front().isNull() && byView.back().isNull());
+}
+
+
+void testValueLazy() {
+	using value_t = gg::ConfigStorage::value_t;
+
+	const string raw = "line\\none\\tand a \\\"quote\\\"";
+	gg::LazyString lazy(raw);
+	const value_t v = value_t::makeLazyString(lazy);
+
+	assert(v.isString() && v.type() == value_t::TYPE::STRING && !lazy.isDecoded());
+	cout << "Decoded: " << v << endl;
+	assert(lazy.isDecoded() && v.asString() == "line\none\tand a \"quote\"");
+
+	// decoded once, then the same bytes every time
+	assert(v.asString().data() == lazy.get().data());
+	assert(v == value_t::makeStringView("line\none\tand a \"quote\""));
+
+	gg::LazyString raced(raw);
+	vector<string_view> results(4);
+	vector<thread> threads;
+	for (size_t i = 0; i < results.size(); ++i)
+		threads.emplace_back([&raced, &results, i]() { results[i] = raced.get(); });
+	for (auto& t: threads)
+		t.join();
+
+	for (const auto& r: results)
+		assert(r.data() == results[0].data() && r == lazy.get());
+}
@@ -0,0 +1,24 @@
+#ifndef GG_CONFIG_TEST_VALUE_HPP
+#define GG_CONFIG_TEST_VALUE_HPP
+
+
+/* Inline and arena-backed strings, numbers, booleans and null */
+void testValueTypes();
+
+/* Strings stay valid after many arena allocations and after moving the storage */
+void testValueArena();
+
+/* Lookups by string_view, const char* and std::string; typed getters with defaults */
+void testValueLookup();
+
+/* Lookups with keys hashed at compile time */
+void testValueConfigKey();
+
+/* Batched lookups give the same values as lookups one by one */
+void testValueBatch();
+
+/* Lazy strings are decoded once, on first access, even when several threads race for it */
+void testValueLazy();
+
+
+#endif // GG_CONFIG_TEST_VALUE_HPP
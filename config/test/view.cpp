@@ -0,0 +1,72 @@
+#include "view.hpp"
+#include "parse.hpp"
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+using namespace std;
+
+
+void testViewSubtree() {
+	gg::ConfigStorage cs;
+	assert(parseText(cs,
+		"service.db.pool = 8 service.db.host = \"db1\"\n"
+		"service.db_backup.host = \"db2\"\n"
+		"service.name = \"api\"\n"
+		"service.dbx = 1\n"
+		"log_level = 3 log_file = \"/var/log/x\" logging = false\n"
+	));
+
+	const gg::ConfigView db = cs.subtree("service.db");
+	vector<string> keys;
+	for (const auto& e: db) {
+		cout << "service.db." << e.key << " = " << e.value << endl;
+		keys.emplace_back(e.key);
+	}
+
+	assert((keys == vector<string>{"host", "pool"}));
+	assert(db.getDouble("pool") == 8 && db.getString("host") == "db1" && db["name"].isNull());
+
+	// views of views
+	const gg::ConfigView service = cs.subtree("service");
+	assert(service.size() == 5 && service.getString("name") == "api");
+	assert(service.subtree("db").size() == 2 && service.subtree("db").getDouble("pool") == 8);
+	assert(service.withPrefix("db").size() == 4);
+
+	// plain prefixes, for keys_with_underscores
+	const gg::ConfigView log = cs.withPrefix("log_");
+	assert(log.size() == 2 && log.getDouble("level") == 3 && log.getString("file") == "/var/log/x");
+	assert(cs.withPrefix("log").size() == 3 && cs.view().size() == cs.storage.size());
+	assert(cs.subtree("nothing").empty() && cs.withPrefix("zzz").empty());
+
+	const char* malformed[] = {"a..b = 1\n", "a. = 1\n", "a.b. = 1\n", "x = a.. = 1\n"};
+	for (const char* text: malformed) {
+		gg::ConfigStorage bad;
+		cout << "Expecting an error for: " << text << flush;
+		assert(!parseText(bad, text));
+	}
+}
+
+
+void testViewRebuild() {
+	gg::ConfigStorage cs;
+	cs.set("a.x", 1.0);
+	cs.set("a.y", 2.0);
+	assert(cs.subtree("a").size() == 2);
+
+	cs.set("a.z", 3.0);
+	cs.set("b.x", 4.0);
+	assert(cs.subtree("a").size() == 3 && cs.subtree("a").getDouble("z") == 3);
+
+	// moving keeps the index; the moved-from storage starts over
+	gg::ConfigStorage moved(std::move(cs));
+	assert(moved.subtree("b").getDouble("x") == 4);
+	assert(cs.view().empty());
+
+	cs.set("c.x", 5.0);
+	assert(cs.storage.size() == 1 && cs.subtree("c").getDouble("x") == 5 && moved.subtree("c").empty());
+	cout << "Index rebuilt after changes and moves." << endl;
+}
@@ -0,0 +1,12 @@
+#ifndef GG_CONFIG_TEST_VIEW_HPP
+#define GG_CONFIG_TEST_VIEW_HPP
+
+
+/* Dotted keys, subtrees and prefix views; malformed dotted keys */
+void testViewSubtree();
+
+/* The index follows changes to the storage, also after it's moved */
+void testViewRebuild();
+
+
+#endif // GG_CONFIG_TEST_VIEW_HPP
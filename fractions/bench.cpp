@@ -0,0 +1,220 @@
+// benchmarks for the fractions library
+#include "gg_fractions.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+
+/* Pairs of random values below 2^bits, negative half of the time for signed types */
+template <typename T>
+vector<T> randomOperands(size_t count, int bits, mt19937_64& rng) {
+	vector<T> operands(count);
+	const unsigned long long mask = bits >= 64 ? ~0ull : (1ull << bits) - 1;
+
+	for (T& x: operands) {
+		x = static_cast<T>(rng() & mask);
+		if (is_signed<T>::value && (rng() & 1) != 0)
+			x = static_cast<T>(-x);
+	}
+
+	return operands;
+}
+
+
+/* Nanoseconds per call, best of a few runs; sink keeps the results alive */
+template <typename T, typename Gcd>
+double timeGcd(const vector<T>& operands, Gcd gcd, unsigned long long& sink) {
+	constexpr int RUNS = 5;
+	double best = 0.0;
+
+	for (int r = 0; r < RUNS; ++r) {
+		const auto begin = chrono::steady_clock::now();
+		for (size_t i = 0; i + 1 < operands.size(); i += 2)
+			sink += static_cast<unsigned long long>(gcd(operands[i], operands[i + 1]));
+		const double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count() / (operands.size() / 2);
+
+		if (r == 0 || ns < best)
+			best = ns;
+	}
+
+	return best;
+}
+
+
+/* Euclid vs binary gcd() for one type, over growing magnitudes; maxBits is the widest one the type holds */
+template <typename T>
+void benchGcd(const char* typeName, int maxBits, unsigned long long& sink) {
+	constexpr size_t PAIRS = 1 << 18;
+	mt19937_64 rng(1);
+
+	for (int step = 8; step < maxBits + 8; step += 8) {
+		const int bits = min(step, maxBits);
+		const vector<T> operands = randomOperands<T>(2 * PAIRS, bits, rng);
+
+		const double euclid = timeGcd(operands, gg::gcd_euclid<T>, sink);
+		const double binary = timeGcd(operands, gg::gcd_binary<T>, sink);
+		printf("%-10s | %4d | %9.2f | %9.2f | %6.2fx\n", typeName, bits, euclid, binary, euclid / binary);
+	}
+}
+
+
+/* reduce() on products of random fractions, which is where gcd() is called from */
+template <typename T>
+void benchReduce(const char* typeName, unsigned long long& sink) {
+	constexpr size_t COUNT = 1 << 18;
+	mt19937_64 rng(2);
+	uniform_int_distribution<int> small(1, 1 << 10);
+
+	vector<gg::fraction<T>> fractions;
+	fractions.reserve(COUNT);
+	for (size_t i = 0; i < COUNT; ++i)
+		fractions.emplace_back(static_cast<T>(small(rng)) * static_cast<T>(small(rng)), static_cast<T>(small(rng)) * static_cast<T>(small(rng)));
+
+	const auto begin = chrono::steady_clock::now();
+	for (const auto& f: fractions)
+		sink += static_cast<unsigned long long>(f.reduce().denominator);
+	const double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count() / COUNT;
+
+	printf("reduce() of fraction<%s>: %.2f ns\n", typeName, ns);
+}
+
+
+/* +, * and < on fractions whose results fit, so it's the cost of the checks on the fast path; policyName's column */
+template <typename T, typename Policy>
+void benchArithmetic(const char* typeName, const char* policyName, unsigned long long& sink) {
+	constexpr size_t COUNT = 1 << 16;
+	constexpr int RUNS = 20;
+	mt19937_64 rng(3);
+	uniform_int_distribution<int> small(1, 1 << 10);
+
+	using frac = gg::fraction<T, Policy>;
+	vector<frac> fractions;
+	fractions.reserve(COUNT);
+	for (size_t i = 0; i < COUNT; ++i)
+		fractions.emplace_back(static_cast<T>(small(rng)), static_cast<T>(small(rng)));
+
+	double best = 0.0;
+	for (int r = 0; r < RUNS; ++r) {
+		const auto begin = chrono::steady_clock::now();
+		for (size_t i = 0; i + 1 < COUNT; ++i) {
+			const frac sum = fractions[i] + fractions[i + 1];
+			const frac product = fractions[i] * fractions[i + 1];
+			sink += static_cast<unsigned long long>(sum.numerator + product.denominator) + (sum < product);
+		}
+		const double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count() / (COUNT - 1);
+
+		if (r == 0 || ns < best)
+			best = ns;
+	}
+
+	printf("%-10s | %-10s | %8.2f\n", typeName, policyName, best);
+}
+
+
+template <typename T>
+void benchPolicies(const char* typeName, unsigned long long& sink) {
+	benchArithmetic<T, gg::overflow_unchecked>(typeName, "unchecked", sink);
+	benchArithmetic<T, gg::overflow_throw>(typeName, "throw", sink);
+	benchArithmetic<T, gg::overflow_saturate>(typeName, "saturate", sink);
+	benchArithmetic<T, gg::overflow_flag>(typeName, "flag", sink);
+}
+
+
+/* A long sum of random terms with small denominators: reduced, the sum stays small; unreduced, it overflows within a few dozen terms.
+Fractions of long long, so checked policies only; unchecked ones are benchmarked when they reduce often enough not to overflow. */
+template <typename... Policies>
+void benchChain(const char* overflowName, const char* reduceName, unsigned long long& sink) {
+	constexpr size_t TERMS = 1 << 18;
+	constexpr int RUNS = 5;
+	using frac = gg::fraction<long long, Policies...>;
+
+	mt19937_64 rng(4);
+	uniform_int_distribution<int> numerators(-2, 2), denominators(2, 16);
+	vector<frac> terms;
+	terms.reserve(TERMS);
+	for (size_t i = 0; i < TERMS; ++i)
+		terms.emplace_back(numerators(rng), denominators(rng));
+
+	double best = 0.0;
+	frac sum;
+	gg::fraction_overflow_flag() = false;
+	for (int r = 0; r < RUNS; ++r) {
+		const auto begin = chrono::steady_clock::now();
+		sum = frac(0, 1);
+		for (const frac& term: terms)
+			sum += term;
+		const double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count() / TERMS;
+
+		if (r == 0 || ns < best)
+			best = ns;
+	}
+	sink += static_cast<unsigned long long>(sum.denominator);
+
+	printf("%-10s | %-10s | %8.2f | %s\n", overflowName, reduceName, best, gg::fraction_overflow_flag() ? "overflowed" : "exact");
+}
+
+
+/* 1/1 + 1/2 + ... in unchecked 64 bit unsigned fractions: the last term the sum is right with */
+template <typename... Policies>
+void benchHarmonic(const char* reduceName) {
+	using frac = gg::fraction<unsigned long long, Policies...>;
+
+	frac sum(0, 1);
+	double reference = 0.0;
+	unsigned long long k = 1;
+	for (; k <= 1000; ++k) {
+		sum += frac(1, k);
+		reference += 1.0 / k;
+		if (fabs(double(sum) - reference) > 1e-9 * reference)
+			break;
+	}
+
+	printf("%-10s | exact up to 1/%llu\n", reduceName, k - 1);
+}
+
+
+int main() {
+	unsigned long long sink = 0;
+
+	printf("%-10s | %4s | %9s | %9s | %7s\n", "type", "bits", "euclid ns", "binary ns", "speedup");
+	benchGcd<int>("int", 31, sink);
+	benchGcd<unsigned>("unsigned", 32, sink);
+	benchGcd<long long>("long long", 63, sink);
+	putchar('\n');
+
+	benchReduce<int>("int", sink);
+	benchReduce<long long>("long long", sink);
+	putchar('\n');
+
+	printf("%-10s | %-10s | %8s\n", "type", "policy", "+ * < ns");
+	benchPolicies<int>("int", sink);
+	benchPolicies<long long>("long long", sink);
+	putchar('\n');
+
+	printf("%-10s | %-10s | %8s | %s\n", "overflow", "reduce", "ns/add", "sum of 2^18 terms");
+	benchChain<gg::overflow_flag, gg::reduce_never>("flag", "never", sink);
+	benchChain<gg::overflow_flag, gg::reduce_above<16>>("flag", "above 2^16", sink);
+	benchChain<gg::overflow_flag, gg::reduce_lazy>("flag", "lazy", sink);
+	benchChain<gg::overflow_flag, gg::reduce_eager>("flag", "eager", sink);
+	benchChain<gg::overflow_unchecked, gg::reduce_lazy>("unchecked", "lazy", sink);
+	benchChain<gg::overflow_unchecked, gg::reduce_eager>("unchecked", "eager", sink);
+	putchar('\n');
+
+	puts("harmonic sum, unchecked unsigned long long:");
+	benchHarmonic<gg::reduce_never>("never");
+	benchHarmonic<gg::reduce_above<16>>("above 2^16");
+	benchHarmonic<gg::reduce_lazy>("lazy");
+	benchHarmonic<gg::reduce_eager>("eager");
+
+	// so the loops can't be optimized away
+	if (sink == 1)
+		puts("");
+
+	return 0;
+}
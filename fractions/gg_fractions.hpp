@@ -10,12 +10,14 @@ the following macro is going to be used instead. The macro is undefined within t
 ; // semicolon to align subsequent lines properly (yup, sublime text)
 
 #include <cmath>
+#include <cstddef>
 #include <exception>
 #include <limits>
 #include <ostream>
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include <utility>
 
 
 namespace gg {
@@ -26,6 +28,7 @@ namespace gg {
 
 	/** Euclidean greatest common divisor algorithm:
 	Practically returns gcd(max(a,b), min(a,b)), to avoid throwing unnecessary exceptions.
+	gcd() uses this for types without a specialization; it's kept callable to compare against them.
 
 	Corner cases:
 		gcd(0, 0):
@@ -34,21 +37,29 @@ namespace gg {
 			Returns 1 (check specializations). I'll probably eliminate this case sometime in the future.
 	*/
 	template <typename Arithmetic>
-	Arithmetic gcd(Arithmetic a, Arithmetic b) noexcept {
+	constexpr Arithmetic gcd_euclid(Arithmetic a, Arithmetic b) noexcept {
 		static_assert(std::is_arithmetic<Arithmetic>::value, "gg::gcd() can only be used on arithmetic types.");
 		constexpr auto ZERO = static_cast<Arithmetic>(0);
 
-		a = std::abs(a);
-		b = std::abs(b);
+		// not std::abs(), which is ambiguous for unsigned types
+		if (a < ZERO)
+			a = -a;
+		if (b < ZERO)
+			b = -b;
 
-		if (a < b)
-			std::swap(a, b);
+		// not std::swap() either, which isn't constexpr before C++20
+		if (a < b) {
+			const Arithmetic tmp = a;
+			a = b;
+			b = tmp;
+		}
 		if (a == ZERO)
 			return ZERO;
+		if (b == ZERO)
+			return a;
 
-		Arithmetic rem;
 		do {
-			rem = a % b;
+			const Arithmetic rem = a % b;
 			a = b;
 			b = rem;
 		} while (b != ZERO);
@@ -57,16 +68,89 @@ namespace gg {
 	}
 
 
+	/** Greatest common divisor; the Euclidean algorithm, unless specialized below. */
+	template <typename Arithmetic>
+	constexpr Arithmetic gcd(Arithmetic a, Arithmetic b) noexcept {
+		return gcd_euclid(a, b);
+	}
+
+
+	/** Number of trailing 0 bits; undefined for 0. */
+	constexpr int count_trailing_zeros(unsigned int x)       noexcept { return __builtin_ctz(x); }
+	constexpr int count_trailing_zeros(unsigned long x)      noexcept { return __builtin_ctzl(x); }
+	constexpr int count_trailing_zeros(unsigned long long x) noexcept { return __builtin_ctzll(x); }
+
+
+	/** Binary (Stein's) greatest common divisor algorithm for integers:
+	Only shifts and subtractions, no division, which is what makes the Euclidean loop slow.
+	Works on the magnitudes as unsigned values, so the most negative value of a signed type is handled too,
+	but its gcd with itself or with 0 doesn't fit into the signed type (neither does its abs()).
+
+	Corner cases:
+		gcd(0, 0):
+			Returns 0.
+		gcd(a, 0), gcd(0, a):
+			Returns abs(a).
+	*/
+	template <typename Integer>
+	constexpr Integer gcd_binary(Integer a, Integer b) noexcept {
+		static_assert(std::is_integral<Integer>::value, "gg::gcd_binary() can only be used on integral types.");
+		// at least unsigned int, which is what count_trailing_zeros() takes
+		using Unsigned = typename std::common_type<typename std::make_unsigned<Integer>::type, unsigned int>::type;
+
+		// the magnitude, without overflowing on the most negative value
+		Unsigned u = static_cast<Unsigned>(a);
+		Unsigned v = static_cast<Unsigned>(b);
+		if (a < 0)
+			u = static_cast<Unsigned>(0u - u);
+		if (b < 0)
+			v = static_cast<Unsigned>(0u - v);
+
+		if (u == 0)
+			return static_cast<Integer>(v);
+		if (v == 0)
+			return static_cast<Integer>(u);
+
+		// the common factors of 2, then both odd: their difference is even, and is shifted down to odd again;
+		// no branch on which one is bigger (that one mispredicts half of the time), and the trailing zeros
+		// are counted on the wrapped difference, which has as many as the real one, so they needn't wait for it
+		const int shift = count_trailing_zeros(u | v);
+		u >>= count_trailing_zeros(u);
+		v >>= count_trailing_zeros(v);
+		while (u != v) {
+			const Unsigned diff = u - v;
+			const int zeros = count_trailing_zeros(diff);
+			const Unsigned smaller = u < v ? u : v;
+			u = (u > v ? diff : v - u) >> zeros;
+			v = smaller;
+		}
+
+		return static_cast<Integer>(u << shift);
+	}
+
+
+	/** Template specializations of gcd() for integers which call gcd_binary(). */
+	template<> constexpr short              gcd<>(short              a, short              b) noexcept { return gcd_binary(a, b); }
+	template<> constexpr int                gcd<>(int                a, int                b) noexcept { return gcd_binary(a, b); }
+	template<> constexpr long               gcd<>(long               a, long               b) noexcept { return gcd_binary(a, b); }
+	template<> constexpr long long          gcd<>(long long          a, long long          b) noexcept { return gcd_binary(a, b); }
+	template<> constexpr unsigned short     gcd<>(unsigned short     a, unsigned short     b) noexcept { return gcd_binary(a, b); }
+	template<> constexpr unsigned int       gcd<>(unsigned int       a, unsigned int       b) noexcept { return gcd_binary(a, b); }
+	template<> constexpr unsigned long      gcd<>(unsigned long      a, unsigned long      b) noexcept { return gcd_binary(a, b); }
+	template<> constexpr unsigned long long gcd<>(unsigned long long a, unsigned long long b) noexcept { return gcd_binary(a, b); }
+
+
 	/** GCD for floating points:
-	Performs the original gcd if if both arguments' fractional part is 0.
-	Otherwise returns 1 or 0, if the any argument == 0. */
+	Performs the original gcd if both arguments are whole numbers within the range of long long.
+	Otherwise returns 1 (or 0, if both arguments == 0). */
 	template <typename FloatingPoint>
-	FloatingPoint gcd_fp(FloatingPoint a, FloatingPoint b) noexcept {
+	constexpr FloatingPoint gcd_fp(FloatingPoint a, FloatingPoint b) noexcept {
 		static_assert(std::is_floating_point<FloatingPoint>::value, "gg::gcd_fp() can only be used on floating point types.");
-		constexpr auto ZERO = static_cast<FloatingPoint>(0);
+		constexpr auto LIMIT = static_cast<FloatingPoint>(1ull << 63);
 
-		FloatingPoint iprt;
-		if(std::modf(a, &iprt) != ZERO || std::modf(b, &iprt) != ZERO)
+		// not std::modf(), which isn't constexpr; the range check keeps the casts defined (and is false for nan)
+		if (!(a > -LIMIT && a < LIMIT && b > -LIMIT && b < LIMIT)
+		    || static_cast<FloatingPoint>(static_cast<long long>(a)) != a || static_cast<FloatingPoint>(static_cast<long long>(b)) != b)
 			return static_cast<FloatingPoint>(1);
 
 		return static_cast<FloatingPoint>(gcd<long long>(static_cast<long long>(a), static_cast<long long>(b)));
@@ -74,9 +158,9 @@ namespace gg {
 
 
 	/** Template specializations of gcd() for floating point values which calls gcd_fp(). */
-	template<> inline float       gcd<>(float       a, float       b) noexcept { return gcd_fp(a, b); }
-	template<> inline double      gcd<>(double      a, double      b) noexcept { return gcd_fp(a, b); }
-	template<> inline long double gcd<>(long double a, long double b) noexcept { return gcd_fp(a, b); }
+	template<> constexpr float       gcd<>(float       a, float       b) noexcept { return gcd_fp(a, b); }
+	template<> constexpr double      gcd<>(double      a, double      b) noexcept { return gcd_fp(a, b); }
+	template<> constexpr long double gcd<>(long double a, long double b) noexcept { return gcd_fp(a, b); }
 
 
 	/** Exception that is generally thrown when there's a 0 in the denominator, or other undefined case is encountered. */
@@ -90,16 +174,244 @@ namespace gg {
 
 
 
+	//------------------------------------------------------------------
+	// Overflow policies
+	//------------------------------------------------------------------
+
+	/** Exception thrown by fractions with the overflow_throw policy, when a result doesn't fit even when reduced. */
+	class FractionOverflow: public IllegalFraction {
+	public:
+		FractionOverflow(const std::string& msg) : IllegalFraction(msg) {;}
+		virtual ~FractionOverflow() {;}
+	};
+
+
+	/** Set by fractions with the overflow_flag policy when a result overflows; one per thread, cleared by the caller. */
+	inline bool& fraction_overflow_flag() noexcept {
+		static thread_local bool flag = false;
+		return flag;
+	}
+
+
+	/** Every policy of gg::fraction derives from the tag of its kind; a fraction takes at most one of each kind, in any order. */
+	struct overflow_policy_tag {};
+	struct reduce_policy_tag {};
+
+
+	/** Policies of gg::fraction for results that don't fit into the type.
+
+	Checked policies compute products and sums in a type twice as wide (fraction_wide), which is exact,
+	and reduce the result before narrowing it, so only results that don't fit even in their lowest terms overflow.
+	Then overflow() gets the result's sign and the magnitudes of its reduced terms in the wide type,
+	and sets the terms of the fraction that's returned. */
+
+	/** No checks: the arithmetic is done in the type itself, and wraps (or is undefined for signed types) as it always did. */
+	struct overflow_unchecked: overflow_policy_tag {
+		static constexpr bool checked = false;
+		static constexpr bool throws = false;
+	};
+
+	/** Throws a FractionOverflow. */
+	struct overflow_throw: overflow_policy_tag {
+		static constexpr bool checked = true;
+		static constexpr bool throws = true;
+
+		template <typename Integer, typename Magnitude>
+		static constexpr void overflow(Integer&, Integer&, bool, Magnitude, Magnitude) {
+			throw FractionOverflow("The result of an operation on gg::fraction-s doesn't fit into its type.");
+		}
+	};
+
+	/** Approximates the result with the closest fraction that fits, more or less:
+	the magnitude is clamped to max/1 (min/1), otherwise both terms are halved until they fit; negative unsigned results become 0/1. */
+	struct overflow_saturate: overflow_policy_tag {
+		static constexpr bool checked = true;
+		static constexpr bool throws = false;
+
+		template <typename Integer, typename Magnitude>
+		static constexpr void overflow(Integer& numerator, Integer& denominator, bool negative, Magnitude n, Magnitude d) noexcept {
+			const auto max = static_cast<Magnitude>(std::numeric_limits<Integer>::max());
+			const Magnitude limit = !negative ? max : std::is_signed<Integer>::value ? max + 1 : 0;
+
+			if (limit == 0) {
+				numerator = 0;
+				denominator = 1;
+				return;
+			}
+
+			if (d == 0 || n / d >= limit) {
+				n = limit;
+				d = d != 0 ? 1 : 0;
+			}
+			while (n > limit || d > max) {
+				n >>= 1;
+				d >>= 1;
+			}
+
+			// the wide type's low bits; for the most negative value that's what it is
+			numerator = static_cast<Integer>(negative ? Magnitude(0) - n : n);
+			denominator = static_cast<Integer>(d);
+		}
+	};
+
+	/** Sets fraction_overflow_flag(), and wraps the reduced result like overflow_unchecked would. */
+	struct overflow_flag: overflow_policy_tag {
+		static constexpr bool checked = true;
+		static constexpr bool throws = false;
+
+		template <typename Integer, typename Magnitude>
+		static void overflow(Integer& numerator, Integer& denominator, bool negative, Magnitude n, Magnitude d) noexcept {
+			fraction_overflow_flag() = true;
+			numerator = static_cast<Integer>(negative ? Magnitude(0) - n : n);
+			denominator = static_cast<Integer>(d);
+		}
+	};
+
+
+#ifdef __SIZEOF_INT128__
+	__extension__ typedef __int128 fraction_int128;
+	__extension__ typedef unsigned __int128 fraction_uint128;
+#endif
+
+
+	/** The type the arithmetic of fraction<Arithmetic, Policy> is done in:
+	for unchecked policies and floating points the type itself, for checked integers a signed type wide enough
+	for a sum of two products to be exact (with the sum of equal denominators done without products). */
+	template <typename Arithmetic, bool Checked, bool Integral = std::is_integral<Arithmetic>::value>
+	struct fraction_wide {
+		using type = Arithmetic;
+	};
+
+	template <typename Integer>
+	struct fraction_wide<Integer, true, true> {
+		static constexpr bool narrow = sizeof(Integer) < 4 || (sizeof(Integer) == 4 && std::is_signed<Integer>::value);
+
+#ifdef __SIZEOF_INT128__
+		static_assert(sizeof(Integer) < 8 || std::is_signed<Integer>::value,
+			"Checked gg::fraction-s of 64 bit unsigned types would need a 129 bit intermediate type; use a signed type, or overflow_unchecked.");
+
+		using type = typename std::conditional<narrow, long long, fraction_int128>::type;
+		using magnitude = typename std::conditional<narrow, unsigned long long, fraction_uint128>::type;
+#else
+		static_assert(narrow, "Checked gg::fraction-s of 32 bit unsigned and 64 bit types need __int128.");
+
+		using type = long long;
+		using magnitude = unsigned long long;
+#endif
+
+		/** Whether both terms fit into Integer, with a single branch: shifted by min, the range is [0, 2^bits), so the two can be or-ed */
+		static constexpr bool fit(type n, type d) noexcept {
+			return ((static_cast<magnitude>(n) - static_cast<magnitude>(std::numeric_limits<Integer>::min()))
+			      | (static_cast<magnitude>(d) - static_cast<magnitude>(std::numeric_limits<Integer>::min())))
+			    >> (std::numeric_limits<Integer>::digits + std::is_signed<Integer>::value) == 0;
+		}
+
+		/** abs() as the unsigned type, so it can't overflow */
+		static constexpr magnitude abs(type x) noexcept {
+			return x < 0 ? magnitude(0) - static_cast<magnitude>(x) : static_cast<magnitude>(x);
+		}
+	};
+
+
+
+	//------------------------------------------------------------------
+	// Reduce policies
+	//------------------------------------------------------------------
+
+	/** Policies of gg::fraction for when results of arithmetic are reduced to their lowest terms:
+	due() tells it from the terms of a result, after the overflow policy had its say. */
+
+	/** Never: terms grow with every operation, until they overflow. reduce() is still there to call. */
+	struct reduce_never: reduce_policy_tag {
+		template <typename Arithmetic>
+		static constexpr bool due(Arithmetic, Arithmetic) noexcept {
+			return false;
+		}
+	};
+
+	/** After every operation: the terms stay as small as they get, for a gcd() each. */
+	struct reduce_eager: reduce_policy_tag {
+		template <typename Arithmetic>
+		static constexpr bool due(Arithmetic, Arithmetic) noexcept {
+			return true;
+		}
+	};
+
+	/** When a term of the result reaches 2^Bits in magnitude. */
+	template <int Bits>
+	struct reduce_above: reduce_policy_tag {
+		template <typename Arithmetic>
+		static constexpr bool due(Arithmetic n, Arithmetic d) noexcept {
+			return beyond(n) || beyond(d);
+		}
+
+	private:
+		template <typename Arithmetic>
+		static constexpr bool beyond(Arithmetic x) noexcept {
+			static_assert(Bits >= 0 && Bits < std::numeric_limits<Arithmetic>::digits, "gg::reduce_above<Bits> needs 2^Bits to fit into the type.");
+			return x >= static_cast<Arithmetic>(1ull << Bits) || (std::is_signed<Arithmetic>::value && x <= -static_cast<Arithmetic>(1ull << Bits));
+		}
+	};
+
+	/** When a term of the result reaches about the square root of the type's range: reduced terms below it can be
+	multiplied, and two such products added, without overflowing, and most results aren't reduced. */
+	struct reduce_lazy: reduce_policy_tag {
+		template <typename Arithmetic>
+		static constexpr bool due(Arithmetic n, Arithmetic d) noexcept {
+			return reduce_above<(std::numeric_limits<Arithmetic>::digits - 1) / 2>::due(n, d);
+		}
+	};
+
+
+	/** The policy of a kind (the one derived from Tag) among a fraction's policies; Default if there's none. */
+	template <typename Tag, typename Default, typename... Policies>
+	struct fraction_policy {
+		using type = Default;
+	};
+
+	template <typename Tag, typename Default, typename First, typename... Rest>
+	struct fraction_policy<Tag, Default, First, Rest...> {
+		using type = typename std::conditional<std::is_base_of<Tag, First>::value, First, typename fraction_policy<Tag, Default, Rest...>::type>::type;
+	};
+
+
+	/** Whether each of a fraction's policies is of a known kind */
+	template <typename... Policies>
+	struct fraction_policies_known: std::true_type {};
+
+	template <typename First, typename... Rest>
+	struct fraction_policies_known<First, Rest...>: std::integral_constant<bool,
+		(std::is_base_of<overflow_policy_tag, First>::value || std::is_base_of<reduce_policy_tag, First>::value) && fraction_policies_known<Rest...>::value> {};
+
+
+	/** Number of a fraction's policies of a kind (derived from Tag) */
+	template <typename Tag, typename... Policies>
+	struct fraction_policy_count: std::integral_constant<std::size_t, 0> {};
+
+	template <typename Tag, typename First, typename... Rest>
+	struct fraction_policy_count<Tag, First, Rest...>: std::integral_constant<std::size_t,
+		(std::is_base_of<Tag, First>::value ? 1 : 0) + fraction_policy_count<Tag, Rest...>::value> {};
+
+
+
 	//------------------------------------------------------------------
 	// class: fraction
 	//------------------------------------------------------------------
 
-	/** Fraction defined on arithmetic types */
-	template <typename Arithmetic>
+	/** Fraction defined on arithmetic types.
+	Policies, in any order: what integer results that don't fit turn into (overflow_*, overflow_unchecked by default),
+	and when results are reduced (reduce_*, reduce_never by default). E.g. fraction<long long, reduce_lazy, overflow_throw>. */
+	template <typename Arithmetic, typename... Policies>
 	class fraction {
+		static_assert(fraction_policies_known<Policies...>::value, "gg::fraction-s only take overflow_* and reduce_* policies.");
+		static_assert(fraction_policy_count<overflow_policy_tag, Policies...>::value <= 1, "gg::fraction-s take at most one overflow_* policy.");
+		static_assert(fraction_policy_count<reduce_policy_tag, Policies...>::value <= 1, "gg::fraction-s take at most one reduce_* policy.");
+
 	public:
 		/** Definitions */
 		using type = Arithmetic;
+		using overflow_policy = typename fraction_policy<overflow_policy_tag, overflow_unchecked, Policies...>::type;
+		using reduce_policy = typename fraction_policy<reduce_policy_tag, reduce_never, Policies...>::type;
 
 
 		/** Attributes */
@@ -113,14 +425,14 @@ namespace gg {
 
 
 		/** Default constructor (1/1): */
-		fraction() noexcept
+		constexpr fraction() noexcept
 			: numerator(ONE)
 			, denominator(ONE)
 		{;}
 
 
 		/** Whole number constructor */
-		fraction(Arithmetic numerator) noexcept
+		constexpr fraction(Arithmetic numerator) noexcept
 			: numerator(numerator)
 			, denominator(ONE)
 		{;}
@@ -136,7 +448,7 @@ namespace gg {
 
 		/** Proper fraction constructor:
 			The type of the arguments can either be any arithmetic type or gg::fraction<T>. */
-		fraction(Arithmetic numerator, Arithmetic denominator) noexcept
+		constexpr fraction(Arithmetic numerator, Arithmetic denominator) noexcept
 			: numerator(numerator)
 			, denominator(denominator)
 		{
@@ -145,21 +457,20 @@ namespace gg {
 
 
 		/** Constructs a fraction from two fractions of the same arithmetic type by dividing them (a/b). */
-		fraction(const fraction& a, const fraction& b)
-			: numerator(a.numerator * b.denominator)
-			, denominator(a.denominator * b.numerator)
+		constexpr fraction(const fraction& a, const fraction& b) noexcept(!overflow_policy::throws)
+			: fraction(a / b)
 		{;}
 
 
 		/** Copy constructor: */
-		fraction(const fraction& other) noexcept
+		constexpr fraction(const fraction& other) noexcept
 			: numerator(other.numerator)
 			, denominator(other.denominator)
 		{;}
 
 
 		/** Copy assignment operator: */
-		fraction& operator=(const fraction& other) noexcept {
+		constexpr fraction& operator=(const fraction& other) noexcept {
 			numerator = other.numerator;
 			denominator = other.denominator;
 
@@ -172,7 +483,7 @@ namespace gg {
 
 		/** Performs the division and returns the resulting float.
 		Returns infinity if the denominator == 0. */
-		operator float() const noexcept {
+		constexpr operator float() const noexcept {
 			if (denominator == ZERO)
 				return std::numeric_limits<float>::infinity();
 
@@ -182,7 +493,7 @@ namespace gg {
 
 		/** Performs the division and returns the resulting double.
 		Returns infinity if the denominator == 0. */
-		operator double() const noexcept {
+		constexpr operator double() const noexcept {
 			if (denominator == ZERO)
 				return std::numeric_limits<double>::infinity();
 
@@ -192,7 +503,7 @@ namespace gg {
 
 		/** Performs the division and returns the resulting long double.
 		Returns infinity if the denominator == 0. */
-		operator long double() const noexcept {
+		constexpr operator long double() const noexcept {
 			if (denominator == ZERO)
 				return std::numeric_limits<long double>::infinity();
 
@@ -203,7 +514,7 @@ namespace gg {
 		/** Performs the division and returns the resulting Arithmetic (gg::fraction<?>::type).
 		If the denominator == 0, a gg::IllegalFraction will be thrown.
 		Not declared as an operator, due to the possible conflicts with the ones up above. */
-		Arithmetic toType() const {
+		constexpr Arithmetic toType() const {
 			if (denominator == ZERO)
 				throw IllegalFraction("May not execute toType() on gg::fraction-s with 0 in the denominator.");
 
@@ -242,51 +553,51 @@ namespace gg {
 
 
 		/** Comparison operators */
-		inline bool operator==(const fraction& other) const noexcept {
-			return denominator != ZERO && other.denominator != ZERO && numerator * other.denominator == other.numerator * denominator;
+		constexpr bool operator==(const fraction& other) const noexcept {
+			return denominator != ZERO && other.denominator != ZERO && wide(numerator) * other.denominator == wide(other.numerator) * denominator;
 		}
 
-		inline bool operator!=(const fraction& other) const noexcept {
+		constexpr bool operator!=(const fraction& other) const noexcept {
 			return !this->operator==(other);
 		}
 
-		inline bool operator<(const fraction& other) const noexcept {
-			return denominator != ZERO && other.denominator != ZERO && numerator * other.denominator < other.numerator * denominator;
+		constexpr bool operator<(const fraction& other) const noexcept {
+			return denominator != ZERO && other.denominator != ZERO && wide(numerator) * other.denominator < wide(other.numerator) * denominator;
 		}
 
-		inline bool operator>(const fraction& other) const noexcept {
-			return denominator != ZERO && other.denominator != ZERO && numerator * other.denominator > other.numerator * denominator;
+		constexpr bool operator>(const fraction& other) const noexcept {
+			return denominator != ZERO && other.denominator != ZERO && wide(numerator) * other.denominator > wide(other.numerator) * denominator;
 		}
 
-		inline bool operator>=(const fraction& other) const noexcept {
-			return denominator != ZERO && other.denominator != ZERO && numerator * other.denominator >= other.numerator * denominator;
+		constexpr bool operator>=(const fraction& other) const noexcept {
+			return denominator != ZERO && other.denominator != ZERO && wide(numerator) * other.denominator >= wide(other.numerator) * denominator;
 		}
 
-		inline bool operator<=(const fraction& other) const noexcept {
-			return denominator != ZERO && other.denominator != ZERO && numerator * other.denominator <= other.numerator * denominator;
+		constexpr bool operator<=(const fraction& other) const noexcept {
+			return denominator != ZERO && other.denominator != ZERO && wide(numerator) * other.denominator <= wide(other.numerator) * denominator;
 		}
 
 
 		/** Unary sign change operator */
-		inline fraction operator-() const noexcept {
-			return fraction(-numerator, denominator);
+		constexpr fraction operator-() const noexcept(!overflow_policy::throws) {
+			return narrow(-wide(numerator), denominator);
 		}
 
 
 		/** Unary sign keep operator (basically replicates the original) */
-		inline fraction operator+() const noexcept {
+		constexpr fraction operator+() const noexcept {
 			return fraction(numerator, denominator);
 		}
 
 
 		/** Invert; returns a fraction containing denominator/numerator. */
-		inline fraction reciprocal() const noexcept {
+		constexpr fraction reciprocal() const noexcept {
 			return fraction(denominator, numerator);
 		}
 
 
 		/** Returns the fraction reduced to it's lowest terms. */
-		fraction reduce() const noexcept {
+		constexpr fraction reduce() const noexcept {
 			if (numerator == ZERO || denominator == ZERO)
 				return fraction(*this);
 			if (numerator == denominator)
@@ -300,7 +611,7 @@ namespace gg {
 
 
 		/** Addition to operator */
-		fraction& operator+=(const fraction& other) {
+		constexpr fraction& operator+=(const fraction& other) {
 			if (denominator == ZERO || other.denominator == ZERO)
 				throw IllegalFraction("Operator+= is undefined when either of the denominators are 0.");
 
@@ -309,10 +620,9 @@ namespace gg {
 			} else if (other.numerator == ZERO) {
 				; // nothing
 			} else if (denominator == other.denominator) {
-				numerator += other.numerator;
+				*this = narrow(wide(numerator) + other.numerator, denominator);
 			} else {
-				numerator = numerator * other.denominator + other.numerator * denominator;
-				denominator *= other.denominator;
+				*this = narrow(wide(numerator) * other.denominator + wide(other.numerator) * denominator, wide(denominator) * other.denominator);
 			}
 
 			return *this;
@@ -320,7 +630,7 @@ namespace gg {
 
 
 		/** Subtraction from operator */
-		fraction& operator-=(const fraction& other) {
+		constexpr fraction& operator-=(const fraction& other) {
 			if (denominator == ZERO || other.denominator == ZERO)
 				throw IllegalFraction("Operator-= is undefined when either of the denominators are 0.");
 
@@ -329,10 +639,9 @@ namespace gg {
 			} else if (other.numerator == ZERO) {
 				; // nothing
 			} else if (denominator == other.denominator) {
-				numerator -= other.numerator;
+				*this = narrow(wide(numerator) - other.numerator, denominator);
 			} else {
-				numerator = numerator * other.denominator - other.numerator * denominator;
-				denominator *= other.denominator;
+				*this = narrow(wide(numerator) * other.denominator - wide(other.numerator) * denominator, wide(denominator) * other.denominator);
 			}
 
 			return *this;
@@ -340,23 +649,19 @@ namespace gg {
 
 
 		/** Multiplication by operator */
-		fraction& operator*=(const fraction& other) noexcept {
-			numerator *= other.numerator;
-			denominator *= other.denominator;
-			return *this;
+		constexpr fraction& operator*=(const fraction& other) noexcept(!overflow_policy::throws) {
+			return *this = narrow(wide(numerator) * other.numerator, wide(denominator) * other.denominator);
 		}
 
 
 		/** Division by operator */
-		fraction& operator/=(const fraction& other) noexcept {
-			numerator *= other.denominator;
-			denominator *= other.numerator;
-			return *this;
+		constexpr fraction& operator/=(const fraction& other) noexcept(!overflow_policy::throws) {
+			return *this = narrow(wide(numerator) * other.denominator, wide(denominator) * other.numerator);
 		}
 
 
 		/** Non-member addition operator */
-		GG_FRACTIONS_FRIEND fraction operator+(const fraction& a, const fraction& b) {
+		GG_FRACTIONS_FRIEND constexpr fraction operator+(const fraction& a, const fraction& b) {
 			if (a.denominator == fraction::ZERO || b.denominator == fraction::ZERO)
 				throw IllegalFraction("Operator+ is undefined when either of the denominators are 0.");
 
@@ -367,11 +672,9 @@ namespace gg {
 			} else if (b.numerator == fraction::ZERO) {
 				result = a; // nothing
 			} else if (a.denominator == b.denominator) {
-				result.numerator = a.numerator + b.numerator;
-				result.denominator = a.denominator;
+				result = narrow(wide(a.numerator) + b.numerator, a.denominator);
 			} else {
-				result.numerator = a.numerator * b.denominator + b.numerator * a.denominator;
-				result.denominator = a.denominator * b.denominator;
+				result = narrow(wide(a.numerator) * b.denominator + wide(b.numerator) * a.denominator, wide(a.denominator) * b.denominator);
 			}
 
 			return result;
@@ -379,7 +682,7 @@ namespace gg {
 
 
 		/** Non-member subtraction operator */
-		GG_FRACTIONS_FRIEND fraction operator-(const fraction& a, const fraction& b) {
+		GG_FRACTIONS_FRIEND constexpr fraction operator-(const fraction& a, const fraction& b) {
 			if (a.denominator == fraction::ZERO || b.denominator == fraction::ZERO)
 				throw IllegalFraction("Operator- is undefined when either of the denominators are 0.");
 
@@ -390,11 +693,9 @@ namespace gg {
 			} else if (b.numerator == fraction::ZERO) {
 				result = a; // nothing
 			} else if (a.denominator == b.denominator) {
-				result.numerator = a.numerator - b.numerator;
-				result.denominator = a.denominator;
+				result = narrow(wide(a.numerator) - b.numerator, a.denominator);
 			} else {
-				result.numerator = a.numerator * b.denominator - b.numerator * a.denominator;
-				result.denominator = a.denominator * b.denominator;
+				result = narrow(wide(a.numerator) * b.denominator - wide(b.numerator) * a.denominator, wide(a.denominator) * b.denominator);
 			}
 
 			return result;
@@ -402,24 +703,87 @@ namespace gg {
 
 
 		/** Non-member multiplication operator */
-		GG_FRACTIONS_FRIEND fraction operator*(const fraction& a, const fraction& b) noexcept {
-			return fraction(a.numerator * b.numerator, a.denominator * b.denominator);
+		GG_FRACTIONS_FRIEND constexpr fraction operator*(const fraction& a, const fraction& b) noexcept(!overflow_policy::throws) {
+			return narrow(wide(a.numerator) * b.numerator, wide(a.denominator) * b.denominator);
 		}
 
 
-		/** Non-member multiplication operator */
-		GG_FRACTIONS_FRIEND fraction operator/(const fraction& a, const fraction& b) noexcept {
-			return fraction(a.numerator * b.denominator, a.denominator * b.numerator);
+		/** Non-member division operator */
+		GG_FRACTIONS_FRIEND constexpr fraction operator/(const fraction& a, const fraction& b) noexcept(!overflow_policy::throws) {
+			return narrow(wide(a.numerator) * b.denominator, wide(a.denominator) * b.numerator);
+		}
+
+
+	private:
+		/** The type products and sums are computed in: Arithmetic itself, unless the policy checks integers */
+		using wide = typename fraction_wide<Arithmetic, overflow_policy::checked>::type;
+		using checks = std::integral_constant<bool, overflow_policy::checked && std::is_integral<Arithmetic>::value>;
+
+
+		/** Turns a result computed in the wide type into a fraction, reduced if the policy says so */
+		static constexpr fraction narrow(wide n, wide d) noexcept(!overflow_policy::throws) {
+			const fraction result = narrow(n, d, checks());
+			return reduce_policy::due(result.numerator, result.denominator) ? result.reduce() : result;
+		}
+
+		static constexpr fraction narrow(wide n, wide d, std::false_type) noexcept {
+			return fraction(static_cast<Arithmetic>(n), static_cast<Arithmetic>(d));
+		}
+
+		/** What fits costs a range check; the rest goes out of line */
+		static constexpr fraction narrow(wide n, wide d, std::true_type) noexcept(!overflow_policy::throws) {
+			using traits = fraction_wide<Arithmetic, true>;
+
+			if (__builtin_expect(traits::fit(n, d), 1))
+				return fraction(static_cast<Arithmetic>(n), static_cast<Arithmetic>(d));
+			return overflowed(n, d);
+		}
+
+		/** Reduces a result that doesn't fit, and leaves it to the policy if it still doesn't */
+		__attribute__((noinline, cold))
+		static constexpr fraction overflowed(wide n, wide d) noexcept(!overflow_policy::throws) {
+			using traits = fraction_wide<Arithmetic, true>;
+			using magnitude = typename traits::magnitude;
+
+			magnitude a = traits::abs(n);
+			magnitude b = traits::abs(d);
+
+			// the wide types aren't integral to <type_traits> in strict modes, so no gcd() here; this path is rare anyway
+			magnitude divisor = a, rem = b;
+			while (rem != 0) {
+				const magnitude next = divisor % rem;
+				divisor = rem;
+				rem = next;
+			}
+
+			if (divisor > 1) {
+				n /= static_cast<wide>(divisor);
+				d /= static_cast<wide>(divisor);
+				a /= divisor;
+				b /= divisor;
+
+				if (traits::fit(n, d))
+					return fraction(static_cast<Arithmetic>(n), static_cast<Arithmetic>(d));
+			}
+
+			fraction result;
+			overflow_policy::overflow(result.numerator, result.denominator, (n < 0) != (d < 0), a, b);
+			return result;
 		}
 	};
 
 
+	/** Fractions that throw a FractionOverflow rather than overflowing */
+	template <typename Integer, typename... Policies>
+	using checked_fraction = fraction<Integer, overflow_throw, Policies...>;
+
+
 } // namespace gg
 
 
 /** Ostream operator for fractions. Outputs numerator/denominator. */
-template <typename T>
-std::ostream& operator<<(std::ostream& out, const gg::fraction<T>& f) {
+template <typename T, typename... P>
+std::ostream& operator<<(std::ostream& out, const gg::fraction<T, P...>& f) {
 	return out << f.numerator << '/' << f.denominator;
 }
 
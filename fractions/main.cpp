@@ -1,7 +1,13 @@
 // examples & tests for the fractions library
 #include "gg_fractions.hpp"
 
+#include <cassert>
+#include <climits>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <type_traits>
+#include <random>
 #include <vector>
 #include <ctime>
 
@@ -129,9 +135,200 @@ void compOpTest() {
 }
 
 
+/* The binary gcd() specializations against the Euclidean one, and on the values that one can't take */
+template <typename T>
+void gcdTypeTest(const char* typeName) {
+	mt19937_64 rng(42);
+	size_t checked = 0;
+
+	for (int bits = 1; bits < static_cast<int>(sizeof(T) * CHAR_BIT); ++bits) {
+		for (int i = 0; i < 2000; ++i) {
+			T a = static_cast<T>(rng() & ((1ull << bits) - 1));
+			T b = static_cast<T>(rng() & ((1ull << (rng() % bits + 1)) - 1));
+			if (is_signed<T>::value && (rng() & 1) != 0)
+				a = static_cast<T>(-a);
+			if (is_signed<T>::value && (rng() & 1) != 0)
+				b = static_cast<T>(-b);
+
+			assert(gg::gcd(a, b) == gg::gcd_euclid(a, b));
+			assert(gg::gcd(b, a) == gg::gcd_euclid(a, b));
+			++checked;
+		}
+	}
+
+	printf("gcd<%s>: %zu random pairs agree\n", typeName, checked);
+}
+
+
+void gcdTest() {
+	puts("--- gcd test ---");
+
+	gcdTypeTest<short>("short");
+	gcdTypeTest<int>("int");
+	gcdTypeTest<unsigned>("unsigned");
+	gcdTypeTest<long long>("long long");
+	gcdTypeTest<unsigned long long>("unsigned long long");
+
+	assert(gg::gcd(0, 0) == 0);
+	assert(gg::gcd(0, -12) == 12 && gg::gcd(-12, 0) == 12);
+	assert(gg::gcd(-12, -18) == 6 && gg::gcd(12u, 18u) == 6u);
+	assert(gg::gcd(INT_MIN, 6) == 2 && gg::gcd(INT_MIN, INT_MIN / 4) == -(INT_MIN / 4));
+	assert(gg::gcd(LLONG_MIN, 3LL) == 1 && gg::gcd(ULLONG_MAX, ULLONG_MAX) == ULLONG_MAX);
+	assert(gg::gcd(1ull << 63, 1ull << 40) == 1ull << 40);
+	assert(gg::gcd(12.0, 18.0) == 6.0 && gg::gcd(1.5, 3.0) == 1.0);
+
+	putchar('\n');
+}
+
+
+/* Checked arithmetic: exact in the wide type, reduced before narrowing, and each policy on what doesn't fit */
+void overflowTest() {
+	using checked = gg::checked_fraction<int>;
+	using saturated = gg::fraction<int, gg::overflow_saturate>;
+	using flagged = gg::fraction<long long, gg::overflow_flag>;
+	constexpr int big = 1 << 20;
+
+	puts("--- overflow test ---");
+
+	// products that only fit reduced, and comparisons of cross products that don't fit
+	const checked product = checked(big, 2 * big) * checked(2 * big, big);
+	assert(product.numerator == 1 && product.denominator == 1);
+	assert(checked(INT_MAX, INT_MAX - 1) < checked(INT_MAX - 1, INT_MAX - 2) && checked(INT_MAX, 2) == checked(INT_MAX, 2));
+	const auto wide = gg::checked_fraction<long long>(LLONG_MAX, 3) / gg::checked_fraction<long long>(LLONG_MAX, 3);
+	assert(wide.numerator == 1 && wide.denominator == 1);
+
+	size_t thrown = 0;
+	try { checked(INT_MAX, 1) + checked(1, 1); } catch (const gg::FractionOverflow&) { ++thrown; }
+	try { -checked(INT_MIN, 1); } catch (const gg::FractionOverflow&) { ++thrown; }
+	try { checked(1, INT_MAX) * checked(1, 3); } catch (const gg::IllegalFraction&) { ++thrown; }
+	assert(thrown == 3);
+
+	// the closest fraction that fits, more or less
+	saturated s = saturated(INT_MAX, 1) * saturated(2, 1);
+	assert(s.numerator == INT_MAX && s.denominator == 1);
+	s = saturated(INT_MIN, 1) * saturated(3, 1);
+	assert(s.numerator == INT_MIN && s.denominator == 1);
+	s = saturated(INT_MAX / 2, 1) * saturated(3, 2);
+	assert(fabs(double(s) / (INT_MAX / 2 * 1.5) - 1) < 1e-6);
+	s = saturated(1, INT_MAX) * saturated(1, INT_MAX);
+	assert(s.numerator == 0);
+	const auto negative = gg::fraction<unsigned, gg::overflow_saturate>(1, 2) - gg::fraction<unsigned, gg::overflow_saturate>(3, 4);
+	assert(negative.numerator == 0 && negative.denominator == 1);
+
+	gg::fraction_overflow_flag() = false;
+	flagged f = flagged(LLONG_MAX / 2, 3) + flagged(LLONG_MAX / 2, 3);
+	assert(!gg::fraction_overflow_flag());
+	f += flagged(LLONG_MAX, 1);
+	assert(gg::fraction_overflow_flag());
+
+	cout << "policies: " << product << ", " << s << ", " << saturated(INT_MAX / 2, 1) * saturated(3, 2) << ", " << f << "\n\n";
+}
+
+
+/* When results are reduced, and policies in any order */
+void reduceTest() {
+	puts("--- reduce policy test ---");
+
+	static_assert(is_same<gg::fraction<int, gg::overflow_throw, gg::reduce_eager>::overflow_policy, gg::overflow_throw>::value
+	           && is_same<gg::fraction<int, gg::reduce_eager, gg::overflow_throw>::overflow_policy, gg::overflow_throw>::value
+	           && is_same<gg::fraction<int, gg::overflow_throw>::reduce_policy, gg::reduce_never>::value
+	           && is_same<gg::fraction<int>::overflow_policy, gg::overflow_unchecked>::value, "policies in any order");
+	static_assert(gg::fraction_policy_count<gg::overflow_policy_tag, gg::overflow_throw, gg::reduce_eager, gg::overflow_saturate>::value == 2
+	           && gg::fraction_policy_count<gg::reduce_policy_tag, gg::overflow_throw, gg::reduce_eager>::value == 1, "duplicate policies are counted (and rejected)");
+
+	const auto plain = gg::fraction<int>(1, 2) + gg::fraction<int>(1, 6);
+	const auto reduced = gg::fraction<int, gg::reduce_eager>(1, 2) + gg::fraction<int, gg::reduce_eager>(1, 6);
+	assert(plain.numerator == 8 && plain.denominator == 12 && reduced.numerator == 2 && reduced.denominator == 3);
+
+	const auto above = gg::fraction<int, gg::reduce_above<4>>(3, 4) * gg::fraction<int, gg::reduce_above<4>>(5, 6);
+	assert(above.numerator == 5 && above.denominator == 8);
+	const auto below = gg::fraction<int, gg::reduce_above<5>>(3, 4) * gg::fraction<int, gg::reduce_above<5>>(5, 6);
+	assert(below.numerator == 15 && below.denominator == 24);
+
+	// a long sum with small denominators stays small if it's reduced now and then; checked ones are also reduced
+	// when they'd overflow, so even never reducing stays exact, just slower
+	using lazy = gg::checked_fraction<long long, gg::reduce_lazy>;
+	using eager = gg::checked_fraction<long long, gg::reduce_eager>;
+	using unreduced = gg::checked_fraction<long long>;
+	lazy lazySum(0, 1);
+	eager eagerSum(0, 1);
+	unreduced sum(0, 1);
+
+	for (int i = 1; i <= 100000; ++i) {
+		const long long d = 2 + i % 11;
+		lazySum += lazy(i % 5 - 2, d);
+		eagerSum += eager(i % 5 - 2, d);
+		sum += unreduced(i % 5 - 2, d);
+	}
+	assert(lazySum.reduce().numerator == eagerSum.numerator && lazySum.reduce().denominator == eagerSum.denominator);
+	assert(sum.reduce().numerator == eagerSum.numerator && sum.reduce().denominator == eagerSum.denominator);
+
+	// unchecked, that's where they part: 1/1 + 1/2 + ... in 64 bits, exact up to 1/43 when reduced, up to 1/20 otherwise
+	gg::fraction<unsigned long long> harmonic(0, 1);
+	gg::fraction<unsigned long long, gg::reduce_lazy> lazyHarmonic(0, 1);
+	double reference = 0.0;
+	int wrongAt = 0;
+	for (unsigned long long k = 1; k <= 43; ++k) {
+		harmonic += gg::fraction<unsigned long long>(1, k);
+		lazyHarmonic += gg::fraction<unsigned long long, gg::reduce_lazy>(1, k);
+		reference += 1.0 / k;
+		if (wrongAt == 0 && fabs(double(harmonic) - reference) > 1e-9)
+			wrongAt = static_cast<int>(k);
+	}
+	assert(wrongAt == 21 && fabs(double(lazyHarmonic) - reference) < 1e-9);
+
+	cout << "sum of 100000 terms: " << eagerSum << " (lazily " << lazySum << ", unreduced " << sum << ")\n"
+	     << "harmonic sum up to 1/43: " << lazyHarmonic.reduce() << ", unreduced goes wrong at 1/" << wrongAt << "\n\n";
+}
+
+
+/* 1/1 + 1/2 + ... + 1/n */
+constexpr gg::fraction<long long, gg::reduce_lazy> harmonicSum(long long n) {
+	gg::fraction<long long, gg::reduce_lazy> sum(0, 1);
+	for (long long k = 1; k <= n; ++k)
+		sum += gg::fraction<long long, gg::reduce_lazy>(1, k);
+	return sum.reduce();
+}
+
+
+/* Fractions as constants: everything but the string conversions folds at compile time */
+void constexprTest() {
+	using rational = gg::fraction<long long, gg::reduce_eager>;
+
+	// unit conversions: Fahrenheit to Celsius, and miles per gallon to km per liter
+	constexpr auto fahrenheit = rational(5, 9);
+	constexpr auto kmPerLiter = rational(1609344, 1000000) / rational(3785411784, 1000000000);
+	constexpr auto roundTrip = fahrenheit * rational(9, 5);
+
+	static_assert(fahrenheit.numerator == 5 && roundTrip == rational(1) && roundTrip.numerator == 1, "folded");
+	static_assert(kmPerLiter.numerator == 48000 && kmPerLiter.denominator == 112903, "reduced on the way");
+	static_assert(kmPerLiter > rational(2, 5) && kmPerLiter < rational(1, 2) && -kmPerLiter < rational(0), "compared");
+
+	// as template arguments: its terms, and whatever's computed from them
+	using ratio = integral_constant<long long, (rational(100) * fahrenheit - rational(32) * fahrenheit).toType()>;
+	static_assert(ratio::value == 37, "truncated");
+	static_assert(double(gg::fraction<int>(1, 4)) == 0.25 && float(gg::fraction<int>(3, 0)) == numeric_limits<float>::infinity(), "converted");
+
+	// gcd(), reduce(), and checked arithmetic too, as long as nothing throws
+	static_assert(gg::gcd(48, -180) == 12 && gg::gcd_euclid(48u, 180u) == 12u && gg::gcd(12.0, 18.0) == 6.0 && gg::gcd(0.5, 1.0) == 1.0, "gcd");
+	static_assert(gg::fraction<short>(-12, 18).reduce() == gg::fraction<short>(-2, 3) && gg::fraction<short>(-12, 18).reduce().numerator == -2, "reduce");
+	static_assert((gg::checked_fraction<int>(INT_MAX, 2) * gg::checked_fraction<int>(2, INT_MAX)).numerator == 1, "reduced before narrowing");
+	static_assert((gg::fraction<int, gg::overflow_saturate>(INT_MAX) + gg::fraction<int, gg::overflow_saturate>(1)).numerator == INT_MAX, "saturated");
+
+	static_assert(harmonicSum(20).numerator == 55835135 && harmonicSum(20).denominator == 15519504, "a loop");
+
+	puts("--- constexpr test ---");
+	cout << "5/9 = " << fahrenheit << ", mpg to km/l = " << kmPerLiter << ", H(20) = " << harmonicSum(20) << "\n\n";
+}
+
+
 int main() {
 	auto begin = clock();
 
+	gcdTest();
+	overflowTest();
+	reduceTest();
+	constexprTest();
 	arithOpTest();
 	compOpTest();
 